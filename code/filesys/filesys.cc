@@ -51,6 +51,7 @@
 #include "directory.h"
 #include "filehdr.h"
 #include "filesys.h"
+#include "synch.h"
 
 // Sectors containing the file headers for the bitmap of free sectors,
 // and the directory of files.  These file headers are placed in well-known 
@@ -81,6 +82,7 @@
 FileSystem::FileSystem(bool format)
 { 
     DEBUG(dbgFile, "Initializing the file system.");
+    metadataLock = new RWLock("file system metadata", TRUE);
     if (format) {
         PersistentBitmap *freeMap = new PersistentBitmap(NumSectors);
         Directory *directory = new Directory(NumDirEntries);
@@ -142,6 +144,20 @@ FileSystem::FileSystem(bool format)
     }
 }
 
+//----------------------------------------------------------------------
+// FileSystem::~FileSystem
+// 	De-allocate the file system data structures: the bitmap and
+//	directory files left open while Nachos is running, and the lock
+//	on them.
+//----------------------------------------------------------------------
+
+FileSystem::~FileSystem()
+{
+    delete freeMapFile;
+    delete directoryFile;
+    delete metadataLock;
+}
+
 //----------------------------------------------------------------------
 // FileSystem::Create
 // 	Create a file in the Nachos file system (similar to UNIX create).
@@ -182,6 +198,7 @@ FileSystem::Create(char *name, int initialSize)
 
     DEBUG(dbgFile, "Creating file " << name << " size " << initialSize);
 
+    metadataLock->AcquireWrite();
     directory = new Directory(NumDirEntries);
     directory->FetchFrom(directoryFile);
 
@@ -210,6 +227,7 @@ FileSystem::Create(char *name, int initialSize)
         delete freeMap;
     }
     delete directory;
+    metadataLock->ReleaseWrite();
     return success;
 }
 
@@ -231,10 +249,12 @@ FileSystem::Open(char *name)
     int sector;
 
     DEBUG(dbgFile, "Opening file" << name);
+    metadataLock->AcquireRead();	// other Opens can look too
     directory->FetchFrom(directoryFile);
     sector = directory->Find(name); 
     if (sector >= 0) 		
 	openFile = new OpenFile(sector);	// name was found in directory 
+    metadataLock->ReleaseRead();
     delete directory;
     return openFile;				// return NULL if not found
 }
@@ -261,11 +281,13 @@ FileSystem::Remove(char *name)
     FileHeader *fileHdr;
     int sector;
     
+    metadataLock->AcquireWrite();
     directory = new Directory(NumDirEntries);
     directory->FetchFrom(directoryFile);
     sector = directory->Find(name);
     if (sector == -1) {
        delete directory;
+       metadataLock->ReleaseWrite();
        return FALSE;			 // file not found 
     }
     fileHdr = new FileHeader;
@@ -282,6 +304,7 @@ FileSystem::Remove(char *name)
     delete fileHdr;
     delete directory;
     delete freeMap;
+    metadataLock->ReleaseWrite();
     return TRUE;
 } 
 
@@ -295,8 +318,10 @@ FileSystem::List()
 {
     Directory *directory = new Directory(NumDirEntries);
 
+    metadataLock->AcquireRead();
     directory->FetchFrom(directoryFile);
     directory->List();
+    metadataLock->ReleaseRead();
     delete directory;
 }
 
@@ -140,6 +140,8 @@ class FileSystem {
 };
 
 #else // FILESYS
+class RWLock;
+
 class FileSystem {
   public:
     FileSystem(bool format);		// Initialize the file system.
@@ -148,6 +150,7 @@ class FileSystem {
     					// If "format", there is nothing on
 					// the disk, so initialize the directory
     					// and the bitmap of free blocks.
+    ~FileSystem();			// De-allocate the file system
 
     bool Create(char *name, int initialSize);  	
 					// Create a file (UNIX creat)
@@ -165,6 +168,8 @@ class FileSystem {
 					// represented as a file
    OpenFile* directoryFile;		// "Root" directory -- list of 
 					// file names, represented as a file
+   RWLock* metadataLock;		// readers of the directory and the
+					// free map share it; writers don't
 };
 
 #endif // FILESYS
@@ -119,6 +119,7 @@ OpenFile::ReadAt(char *into, int numBytes, int position)
 {
     int fileLength = hdr->FileLength();
     int i, firstSector, lastSector, numSectors;
+    int *sectors;
     char *buf;
 
     if ((numBytes <= 0) || (position >= fileLength))
@@ -132,11 +133,13 @@ OpenFile::ReadAt(char *into, int numBytes, int position)
     lastSector = divRoundDown(position + numBytes - 1, SectorSize);
     numSectors = 1 + lastSector - firstSector;
 
-    // read in all the full and partial sectors that we need
+    // read in all the full and partial sectors that we need, at once
     buf = new char[numSectors * SectorSize];
+    sectors = new int[numSectors];
     for (i = firstSector; i <= lastSector; i++)	
-        kernel->synchDisk->ReadSector(hdr->ByteToSector(i * SectorSize), 
-					&buf[(i - firstSector) * SectorSize]);
+        sectors[i - firstSector] = hdr->ByteToSector(i * SectorSize);
+    kernel->synchDisk->ReadSectors(sectors, buf, numSectors);
+    delete [] sectors;
 
     // copy the part we want
     bcopy(&buf[position - (firstSector * SectorSize)], into, numBytes);
@@ -150,6 +153,7 @@ OpenFile::WriteAt(char *from, int numBytes, int position)
     int fileLength = hdr->FileLength();
     int i, firstSector, lastSector, numSectors;
     bool firstAligned, lastAligned;
+    int *sectors;
     char *buf;
 
     if ((numBytes <= 0) || (position >= fileLength))
@@ -177,10 +181,12 @@ OpenFile::WriteAt(char *from, int numBytes, int position)
 // copy in the bytes we want to change 
     bcopy(from, &buf[position - (firstSector * SectorSize)], numBytes);
 
-// write modified sectors back
+// write modified sectors back, all at once
+    sectors = new int[numSectors];
     for (i = firstSector; i <= lastSector; i++)	
-        kernel->synchDisk->WriteSector(hdr->ByteToSector(i * SectorSize), 
-					&buf[(i - firstSector) * SectorSize]);
+        sectors[i - firstSector] = hdr->ByteToSector(i * SectorSize);
+    kernel->synchDisk->WriteSectors(sectors, buf, numSectors);
+    delete [] sectors;
     delete [] buf;
     return numBytes;
 }
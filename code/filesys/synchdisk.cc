@@ -7,8 +7,15 @@
 //
 //	Use a semaphore to synchronize the interrupt handlers with the
 //	pending requests.  And, because the physical disk can only
-//	handle one operation at a time, use a lock to enforce mutual
-//	exclusion.
+//	handle one operation at a time, requests wait their turn on a
+//	queue; a lock lets only one thread at a time wait for the disk,
+//	so the semaphore is always for that thread.
+//
+//	Requests from stackless tasks go on the same queue, but nobody
+//	waits for them: the interrupt handler resumes the task instead.
+//	A thread can queue up several requests at once (ReadSectors,
+//	WriteSectors); the interrupt handler counts them off, and wakes
+//	the thread when the last one finishes.
 //
 // Copyright (c) 1992-1993 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -17,6 +24,24 @@
 #include "copyright.h"
 #include "synchdisk.h"
 
+// The following class defines the task SynchDisk::SelfTest runs for
+// every sector: save the sector, write a pattern over it, read the
+// pattern back and check it, then put back what was there.
+
+class SectorCheck : public Task {
+  public:
+    SectorCheck(int sector, Semaphore *allDone) : Task("sector check")
+	{ sectorNumber = sector; done = allDone; }
+
+    bool Step();
+
+  private:
+    int sectorNumber;		// the sector to check
+    Semaphore *done;		// V'd when the check is finished
+    char saved[SectorSize];	// what the sector held
+    char data[SectorSize];	// the pattern, then what was read back
+};
+
 
 //----------------------------------------------------------------------
 // SynchDisk::SynchDisk
@@ -29,6 +54,9 @@ SynchDisk::SynchDisk()
 {
     semaphore = new Semaphore("synch disk", 0);
     lock = new Lock("synch disk lock");
+    pending = new List<DiskRequest *>;
+    current = NULL;
+    numWaiting = 0;
     disk = new Disk(this);
 }
 
@@ -41,6 +69,10 @@ SynchDisk::SynchDisk()
 SynchDisk::~SynchDisk()
 {
     delete disk;
+    while (!pending->IsEmpty()) {
+	delete pending->RemoveFront();
+    }
+    delete pending;
     delete lock;
     delete semaphore;
 }
@@ -57,10 +89,7 @@ SynchDisk::~SynchDisk()
 void
 SynchDisk::ReadSector(int sectorNumber, char* data)
 {
-    lock->Acquire();			// only one disk I/O at a time
-    disk->ReadRequest(sectorNumber, data);
-    semaphore->P();			// wait for interrupt
-    lock->Release();
+    Transfer(&sectorNumber, data, 1, FALSE);
 }
 
 //----------------------------------------------------------------------
@@ -75,20 +104,225 @@ SynchDisk::ReadSector(int sectorNumber, char* data)
 void
 SynchDisk::WriteSector(int sectorNumber, char* data)
 {
-    lock->Acquire();			// only one disk I/O at a time
-    disk->WriteRequest(sectorNumber, data);
-    semaphore->P();			// wait for interrupt
+    Transfer(&sectorNumber, data, 1, TRUE);
+}
+
+//----------------------------------------------------------------------
+// SynchDisk::ReadSectorAsync, SynchDisk::WriteSectorAsync
+// 	Start reading or writing a disk sector, and return right away;
+//	"task" is resumed once the data has been read or written.
+//
+//	"sectorNumber" -- the disk sector to read or write
+//	"data" -- the buffer, which must stay allocated until then
+//	"task" -- the task waiting for the data
+//----------------------------------------------------------------------
+
+void
+SynchDisk::ReadSectorAsync(int sectorNumber, char* data, Task* task)
+{
+    ASSERT(task != NULL);
+    Submit(new DiskRequest(sectorNumber, data, FALSE, task));
+}
+
+void
+SynchDisk::WriteSectorAsync(int sectorNumber, char* data, Task* task)
+{
+    ASSERT(task != NULL);
+    Submit(new DiskRequest(sectorNumber, data, TRUE, task));
+}
+
+//----------------------------------------------------------------------
+// SynchDisk::ReadSectors, SynchDisk::WriteSectors, SynchDisk::Transfer
+// 	Read or write several disk sectors, and return only after they
+//	all have been read or written.  The requests are queued all at
+//	once, so the disk goes straight from one to the next, and the
+//	thread is woken up once, rather than once per sector.
+//
+//	"sectorNumbers" -- the disk sectors to read or write
+//	"data" -- the buffer, holding "count" sectors, in the same order
+//	"count" -- how many sectors
+//----------------------------------------------------------------------
+
+void
+SynchDisk::ReadSectors(int *sectorNumbers, char* data, int count)
+{
+    Transfer(sectorNumbers, data, count, FALSE);
+}
+
+void
+SynchDisk::WriteSectors(int *sectorNumbers, char* data, int count)
+{
+    Transfer(sectorNumbers, data, count, TRUE);
+}
+
+void
+SynchDisk::Transfer(int *sectorNumbers, char* data, int count, bool write)
+{
+    ASSERT(count > 0);
+    lock->Acquire();			// only one thread waits at a time
+    ASSERT(numWaiting == 0);
+    numWaiting = count;			// before the first can finish
+    for (int i = 0; i < count; i++) {
+	Submit(new DiskRequest(sectorNumbers[i], &data[i * SectorSize],
+			       write, NULL));
+    }
+    semaphore->P();			// wait for the last interrupt
     lock->Release();
 }
 
+//----------------------------------------------------------------------
+// SynchDisk::Submit
+// 	Queue a request, and if the disk is idle, start it.  Interrupts
+//	are disabled, as the interrupt handler starts queued requests.
+//----------------------------------------------------------------------
+
+void
+SynchDisk::Submit(DiskRequest *request)
+{
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+
+    pending->Append(request);
+    if (current == NULL) {
+	StartNext();
+    }
+    (void) kernel->interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// SynchDisk::StartNext
+// 	Send the first queued request, if any, to the disk.
+//----------------------------------------------------------------------
+
+void
+SynchDisk::StartNext()
+{
+    ASSERT(current == NULL);
+    if (pending->IsEmpty()) {
+	return;
+    }
+    current = pending->RemoveFront();
+    if (current->write) {
+	disk->WriteRequest(current->sectorNumber, current->data);
+    } else {
+	disk->ReadRequest(current->sectorNumber, current->data);
+    }
+}
+
 //----------------------------------------------------------------------
 // SynchDisk::CallBack
-// 	Disk interrupt handler.  Wake up any thread waiting for the disk
-//	request to finish.
+// 	Disk interrupt handler.  Resume the task waiting for the disk
+//	request to finish, or, if it was the last of the waiting
+//	thread's requests, wake up the thread; then start the next one.
 //----------------------------------------------------------------------
 
 void
 SynchDisk::CallBack()
 { 
-    semaphore->V();
+    DiskRequest *done = current;
+
+    current = NULL;
+    StartNext();
+    if (done->task != NULL) {
+	done->task->Resume();
+    } else if (--numWaiting == 0) {
+	semaphore->V();
+    }
+    delete done;
+}
+
+//----------------------------------------------------------------------
+// SectorCheck::Step
+// 	Start the next request of the check, or, when it is finished,
+//	tell SynchDisk::SelfTest.
+//----------------------------------------------------------------------
+
+bool
+SectorCheck::Step()
+{
+    int i;
+
+    switch (state) {
+      case 0:				// save the sector
+	state = 1;
+	kernel->synchDisk->ReadSectorAsync(sectorNumber, saved, this);
+	return TRUE;
+      case 1:				// write a pattern over it
+	state = 2;
+	for (i = 0; i < SectorSize; i++) {
+	    data[i] = (char) (sectorNumber + i);
+	}
+	kernel->synchDisk->WriteSectorAsync(sectorNumber, data, this);
+	return TRUE;
+      case 2:				// read it back
+	state = 3;
+	bzero(data, SectorSize);
+	kernel->synchDisk->ReadSectorAsync(sectorNumber, data, this);
+	return TRUE;
+      case 3:				// check it, put the sector back
+	state = 4;
+	for (i = 0; i < SectorSize; i++) {
+	    ASSERT(data[i] == (char) (sectorNumber + i));
+	}
+	kernel->synchDisk->WriteSectorAsync(sectorNumber, saved, this);
+	return TRUE;
+      default:
+	done->V();
+	return FALSE;
+    }
+}
+
+//----------------------------------------------------------------------
+// SynchDisk::SelfTest
+// 	Start a SectorCheck task on each of the last "numTasks" sectors,
+//	all at once, and wait for them all to finish; then do the same
+//	with ReadSectors and WriteSectors, on the last few sectors.
+//	The disk is left as it was.  Only a handful of sectors are
+//	touched, and none of those the file system keeps its free map
+//	and directory in, so as little as possible is lost if Nachos
+//	dies in the middle.
+//
+//	Print what the outstanding tasks cost, next to what a thread per
+//	request would have cost in stacks alone.
+//----------------------------------------------------------------------
+
+void
+SynchDisk::SelfTest(int numTasks)
+{
+    const int numBatch = 4;
+    Semaphore *done = new Semaphore("disk test", 0);
+    int sectors[numBatch];
+    char saved[numBatch * SectorSize];
+    char data[numBatch * SectorSize];
+    int start = kernel->stats->totalTicks;
+    int i;
+
+    ASSERT(numTasks >= numBatch && numTasks <= NumSectors / 2);
+    for (i = 0; i < numTasks; i++) {
+	(new SectorCheck(NumSectors - 1 - i, done))->Start();
+    }
+    for (i = 0; i < numTasks; i++) {
+	done->P();
+    }
+    cout << "SynchDisk: " << numTasks << " tasks, " << 4 * numTasks;
+    cout << " requests, in " << kernel->stats->totalTicks - start;
+    cout << " ticks\n";
+    cout << "    task state " << numTasks * sizeof(SectorCheck);
+    cout << " bytes; a thread per task would need ";
+    cout << numTasks * StackSize * sizeof(int) << " bytes of stack\n";
+    delete done;
+
+    for (i = 0; i < numBatch; i++) {
+	sectors[i] = NumSectors - numBatch + i;	// in any order
+    }
+    ReadSectors(sectors, saved, numBatch);
+    for (i = 0; i < numBatch * SectorSize; i++) {
+	data[i] = (char) i;
+    }
+    WriteSectors(sectors, data, numBatch);
+    bzero(data, numBatch * SectorSize);
+    ReadSectors(sectors, data, numBatch);
+    for (i = 0; i < numBatch * SectorSize; i++) {
+	ASSERT(data[i] == (char) i);
+    }
+    WriteSectors(sectors, saved, numBatch);
 }
@@ -14,6 +14,25 @@
 #include "disk.h"
 #include "synch.h"
 #include "callback.h"
+#include "list.h"
+#include "task.h"
+
+// The following class defines a request waiting for the disk.
+// "task" is the task to resume when it is done, or NULL if a thread
+// is waiting for it in ReadSector, WriteSector, ReadSectors or
+// WriteSectors.
+
+class DiskRequest {
+  public:
+    DiskRequest(int sector, char *buffer, bool isWrite, Task *toResume)
+	{ sectorNumber = sector; data = buffer; write = isWrite;
+	  task = toResume; }
+
+    int sectorNumber;		// which sector
+    char *data;			// to read into, or to write from
+    bool write;			// TRUE to write, FALSE to read
+    Task *task;			// who is waiting for it
+};
 
 // The following class defines a "synchronous" disk abstraction.
 // As with other I/O devices, the raw physical disk is an asynchronous device --
@@ -24,7 +43,9 @@
 //
 // This class provides the abstraction that for any individual thread
 // making a request, it waits around until the operation finishes before
-// returning.
+// returning.  A stackless task (see task.h) can instead start a
+// request and be resumed when it finishes; any number of those can
+// be outstanding, queued up behind the one the disk is doing.
 
 class SynchDisk : public CallBackObj {
   public:
@@ -39,6 +60,21 @@ class SynchDisk : public CallBackObj {
     					// Disk::ReadRequest/WriteRequest and
 					// then wait until the request is done.
     void WriteSector(int sectorNumber, char* data);
+
+    void ReadSectorAsync(int sectorNumber, char* data, Task* task);
+    					// Read/write a disk sector, returning
+					// right away; "task" is resumed
+					// once the data is read or written
+    void WriteSectorAsync(int sectorNumber, char* data, Task* task);
+
+    void ReadSectors(int *sectorNumbers, char* data, int count);
+    					// Read/write "count" sectors, to or
+					// from consecutive parts of "data";
+					// start them all at once, and return
+					// once they are all done
+    void WriteSectors(int *sectorNumbers, char* data, int count);
+
+    void SelfTest(int numTasks);	// run numTasks tasks at once
     
     void CallBack();			// Called by the disk device interrupt
 					// handler, to signal that the
@@ -48,8 +84,18 @@ class SynchDisk : public CallBackObj {
     Disk *disk;		  		// Raw disk device
     Semaphore *semaphore; 		// To synchronize requesting thread 
 					// with the interrupt handler
-    Lock *lock;		  		// Only one read/write request
-					// can be sent to the disk at a time
+    Lock *lock;		  		// Only one thread at a time
+					// waits for the disk
+    List<DiskRequest *> *pending;	// requests not yet sent to the disk
+    DiskRequest *current;		// the one the disk is doing, if any
+    int numWaiting;			// requests the waiting thread has
+					// yet to see finish
+
+    void Submit(DiskRequest *request);	// queue a request, and send it
+					// to the disk if that is idle
+    void StartNext();			// send the next queued request
+    void Transfer(int *sectorNumbers, char* data, int count, bool write);
+    					// ReadSectors or WriteSectors
 };
 
 #endif // SYNCHDISK_H
@@ -0,0 +1,375 @@
+// heap.cc
+//     	Routines to manage a binary heap of "things".
+//	Heaps are implemented as templates so that we can store
+//	anything on the heap in a type-safe manner.
+//
+//	The heap is kept in an array that grows (by doubling) as
+//	needed, so Insert and RemoveFront do not allocate anything
+//	in the common case.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+
+const int HeapInitialSize = 16;		// elements allocated up front
+
+//----------------------------------------------------------------------
+// Heap<T>::Heap
+//	Initialize a heap, empty to start with.
+//
+//	"comp" orders the items on the heap.
+//	"idx" returns where an item keeps its heap position, or is
+//		NULL if items don't keep track of it.
+//----------------------------------------------------------------------
+
+template <class T>
+Heap<T>::Heap(int (*comp)(T x, T y), int *(*idx)(T x))
+{
+    compare = comp;
+    index = idx;
+    numInList = 0;
+    numAllocated = HeapInitialSize;
+    nextSeq = 0;
+    elements = new HeapElement<T>[numAllocated];
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::~Heap
+//	Prepare a heap for deallocation.
+//      This does *NOT* free the data the heap points to.
+//----------------------------------------------------------------------
+
+template <class T>
+Heap<T>::~Heap()
+{
+    delete [] elements;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Less
+//	Return TRUE if elements[i] should come off the heap before
+//	elements[j].  Equal items come off in insertion order.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+Heap<T>::Less(int i, int j) const
+{
+    int cmp = compare(elements[i].item, elements[j].item);
+
+    if (cmp != 0) {
+	return cmp < 0;
+    }
+    // sequence numbers may wrap; compare them as a difference
+    return (int) (elements[i].seq - elements[j].seq) < 0;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Place
+//	Store "element" at position "pos", and tell the item where
+//	it now lives.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Place(int pos, HeapElement<T> element)
+{
+    elements[pos] = element;
+    if (index != NULL) {
+	*(*index)(element.item) = pos;
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SiftUp, SiftDown
+//	Move the element at "pos" towards the root (or the leaves)
+//	until the heap property holds again.
+//
+// Returns:
+//	The element's new position.
+//----------------------------------------------------------------------
+
+template <class T>
+int
+Heap<T>::SiftUp(int pos)
+{
+    HeapElement<T> element = elements[pos];
+    int parent;
+
+    while (pos > 0) {
+	parent = (pos - 1) / 2;
+	elements[numInList] = element;		// scratch slot, for Less()
+	if (!Less(numInList, parent)) {
+	    break;
+	}
+	Place(pos, elements[parent]);
+	pos = parent;
+    }
+    Place(pos, element);
+    return pos;
+}
+
+template <class T>
+int
+Heap<T>::SiftDown(int pos)
+{
+    HeapElement<T> element = elements[pos];
+    int child;
+
+    for (;;) {
+	child = 2 * pos + 1;
+	if (child >= numInList) {
+	    break;
+	}
+	if (child + 1 < numInList && Less(child + 1, child)) {
+	    child++;				// pick the smaller child
+	}
+	elements[numInList] = element;		// scratch slot, for Less()
+	if (!Less(child, numInList)) {
+	    break;
+	}
+	Place(pos, elements[child]);
+	pos = child;
+    }
+    Place(pos, element);
+    return pos;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Insert
+//      Put an "item" on the heap, in O(log n).
+//
+//	Grow the array if it is full.  One slot past the last element
+//	is always kept free, as scratch space for SiftUp/SiftDown.
+//
+//	"item" is the thing to put on the heap.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Insert(T item)
+{
+    HeapElement<T> element;
+
+    ASSERT(!IsInList(item));
+    if (numInList + 1 >= numAllocated) {
+	HeapElement<T> *bigger = new HeapElement<T>[numAllocated * 2];
+	for (int i = 0; i < numInList; i++) {
+	    bigger[i] = elements[i];
+	}
+	delete [] elements;
+	elements = bigger;
+	numAllocated *= 2;
+    }
+    element.item = item;
+    element.seq = nextSeq++;
+    numInList++;
+    Place(numInList - 1, element);
+    SiftUp(numInList - 1);
+    ASSERT(IsInList(item));
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::RemoveAt
+//      Take the element at "pos" off the heap, filling the hole
+//	with the last element and moving that to its proper place.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::RemoveAt(int pos)
+{
+    T item = elements[pos].item;
+
+    ASSERT(pos >= 0 && pos < numInList);
+    numInList--;
+    if (pos != numInList) {
+	Place(pos, elements[numInList]);
+	SiftUp(SiftDown(pos));
+    }
+    if (index != NULL) {
+	*(*index)(item) = -1;
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::RemoveFront
+//      Remove the smallest "item" from the heap.  Heap must not be
+//	empty.
+//
+// Returns:
+//	The removed item.
+//----------------------------------------------------------------------
+
+template <class T>
+T
+Heap<T>::RemoveFront()
+{
+    T thing;
+
+    ASSERT(!IsEmpty());
+    thing = elements[0].item;
+    RemoveAt(0);
+    return thing;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Remove
+//      Remove a specific item from the heap.  Must be on the heap!
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Remove(T item)
+{
+    RemoveAt(Find(item));
+    ASSERT(!IsInList(item));
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Update
+//      The key of "item" has changed (in either direction) since
+//	it was inserted; move it to wherever it now belongs.  Must be
+//	on the heap!  The item keeps its place among equal items.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Update(T item)
+{
+    int pos = Find(item);
+
+    ASSERT(pos >= 0);
+    SiftDown(SiftUp(pos));
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Find
+//      Return the position of "item" on the heap, or -1 if it isn't
+//	there.  O(1) if items track their own position.
+//----------------------------------------------------------------------
+
+template <class T>
+int
+Heap<T>::Find(T item) const
+{
+    if (index != NULL) {
+	int pos = *(*index)(item);
+
+	if (pos >= 0 && pos < numInList && elements[pos].item == item) {
+	    return pos;
+	}
+	return -1;
+    }
+    for (int i = 0; i < numInList; i++) {
+        if (item == elements[i].item) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::IsInList
+//      Return TRUE if the item is on the heap.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+Heap<T>::IsInList(T item) const
+{
+    return Find(item) >= 0;
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::Apply
+//      Apply function to every item on the heap, in heap (not sorted)
+//	order.  "func" must not change the order of the items.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::Apply(void (*func)(T)) const
+{
+    for (int i = 0; i < numInList; i++) {
+        (*func)(elements[i].item);
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SanityCheck
+//      Test whether this is still a legal heap.
+//
+//	Tests: is every element no smaller than its parent?
+//	       does every item know where it is?
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SanityCheck() const
+{
+    ASSERT(numInList >= 0 && numInList < numAllocated);
+    for (int i = 1; i < numInList; i++) {
+	ASSERT(!Less(i, (i - 1) / 2));
+    }
+    if (index != NULL) {
+	for (int i = 0; i < numInList; i++) {
+	    ASSERT(*(*index)(elements[i].item) == i);
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// Heap<T>::SelfTest
+//      Test whether this module is working.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+Heap<T>::SelfTest(T *p, int numEntries)
+{
+    int i;
+    T *q = new T[numEntries];
+
+    SanityCheck();
+    ASSERT(IsEmpty());
+
+    // put everything in, then take it out from the middle
+    for (i = 0; i < numEntries; i++) {
+	Insert(p[i]);
+	ASSERT(IsInList(p[i]));
+	ASSERT(!IsEmpty());
+    }
+    SanityCheck();
+    for (i = 0; i < numEntries; i++) {
+	Remove(p[i]);
+	ASSERT(!IsInList(p[i]));
+	SanityCheck();
+    }
+    ASSERT(IsEmpty());
+
+    // put everything in again; it should come out sorted
+    for (i = 0; i < numEntries; i++) {
+	Insert(p[i]);
+    }
+    Update(p[0]);			// unchanged key, must be a no-op
+    SanityCheck();
+    for (i = 0; i < numEntries; i++) {
+	ASSERT(Front() == elements[0].item);
+	q[i] = RemoveFront();
+	ASSERT(!IsInList(q[i]));
+    }
+    ASSERT(IsEmpty());
+    for (i = 0; i < (numEntries - 1); i++) {
+	ASSERT(compare(q[i], q[i + 1]) <= 0);
+    }
+    SanityCheck();
+
+    delete [] q;
+}
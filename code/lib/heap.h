@@ -0,0 +1,116 @@
+// heap.h
+//	Data structures to manage a binary heap ("priority queue").
+//
+//	Like a SortedList, a Heap always hands back its smallest element
+//	first.  Unlike a SortedList, Insert and RemoveFront are O(log n)
+//	instead of O(n), and the smallest element can be looked at
+//	in O(1) -- which matters once there are thousands of items.
+//
+//	Items with equal keys come out in the order they were inserted,
+//	exactly as they would from a SortedList.
+//
+//	If the caller supplies an "index" function, each item records
+//	its own position in the heap.  That makes IsInList O(1), and lets
+//	an item whose key has changed be moved to its new position
+//	(Update, i.e., decrease-key / increase-key) or taken out of the
+//	middle of the heap (Remove) in O(log n).  Without an index function
+//	those operations have to search the heap first.
+//
+//	Allocation and deallocation of the items in the heap are to be
+//	done by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "copyright.h"
+#include "debug.h"
+
+// The following class defines a "heap element" -- the item, plus
+// the sequence number it was inserted with (used to break ties, so
+// that equal items stay first-come first-served).
+//
+// This class is private to this module.  Made public for notational
+// convenience.
+
+template <class T>
+class HeapElement {
+  public:
+    T item;			// item on the heap
+    unsigned int seq;		// insertion order, to break ties
+};
+
+// The following class defines a "heap" -- an array-based binary heap,
+// arranged so that RemoveFront always returns the smallest element.
+// All types to be inserted onto a heap must have a "Compare" function
+// defined, as for SortedList:
+//	   int Compare(T x, T y)
+//		returns -1 if x < y
+//		returns 0 if x == y
+//		returns 1 if x > y
+//
+// The optional "Index" function returns where the item keeps its
+// heap position:
+//	   int *Index(T x)
+// The heap stores the position there on every move, and -1 when
+// the item leaves the heap.  An item can be on at most one indexed
+// heap at a time.
+
+template <class T>
+class Heap {
+  public:
+    Heap(int (*comp)(T x, T y), int *(*idx)(T x) = NULL);
+				// initialize the heap
+    ~Heap();			// de-allocate the heap
+
+    void Insert(T item); 	// put an item onto the heap
+    T Front() { ASSERT(!IsEmpty()); return elements[0].item; }
+    				// Return smallest item on heap
+				// without removing it
+    T RemoveFront(); 		// Take smallest item off the heap
+    void Remove(T item); 	// Remove specific item from heap
+    void Update(T item);	// item's key has changed, move it
+				// to its new place
+
+    bool IsInList(T item) const;// is the item on the heap?
+
+    unsigned int NumInList() { return numInList; }
+    				// how many items on the heap?
+    bool IsEmpty() { return (numInList == 0); }
+    				// is the heap empty?
+
+    void Apply(void (*f)(T)) const;
+    				// apply function to all elements on
+				// the heap, in no particular order
+
+    void SanityCheck() const;	// has this heap been corrupted?
+    void SelfTest(T *p, int numEntries);
+				// verify module is working
+
+  private:
+    HeapElement<T> *elements;	// the heap, smallest at elements[0]
+    int numInList;		// number of items on the heap
+    int numAllocated;		// size of "elements"
+    unsigned int nextSeq;	// sequence number for the next Insert
+
+    int (*compare)(T x, T y);	// function for ordering heap elements
+    int *(*index)(T x);		// where an item keeps its position,
+				// NULL if items don't track it
+
+    bool Less(int i, int j) const;
+				// should elements[i] come out before [j]?
+    void Place(int pos, HeapElement<T> element);
+    				// store element at pos, recording pos
+    int SiftUp(int pos);	// restore heap order above pos
+    int SiftDown(int pos);	// restore heap order below pos
+    int Find(T item) const;	// position of item, -1 if not on heap
+    void RemoveAt(int pos);	// take elements[pos] off the heap
+};
+
+#include "heap.cc"		// templates are really like macros
+				// so needs to be included in every
+				// file that uses the template
+#endif // HEAP_H
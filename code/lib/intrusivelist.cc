@@ -0,0 +1,317 @@
+// intrusivelist.cc
+//     	Routines to manage a doubly linked list of "things", each of
+//	which carries its own link.
+//
+//	Nothing here allocates memory: the links are part of the items,
+//	and are set up when the items are.
+//
+//     	NOTE: Mutual exclusion must be provided by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::IntrusiveList
+//	Initialize a list, empty to start with.
+//
+//	"lnk" returns where an item keeps the link this list uses.
+//----------------------------------------------------------------------
+
+template <class T>
+IntrusiveList<T>::IntrusiveList(ListLink<T> *(*lnk)(T x))
+{
+    first = last = NULL;
+    numInList = 0;
+    link = lnk;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::~IntrusiveList
+//	Prepare a list for deallocation.
+//      This does *NOT* free the items on the list.
+//      Normally, the list should be empty when this is called.
+//----------------------------------------------------------------------
+
+template <class T>
+IntrusiveList<T>::~IntrusiveList()
+{
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::InsertAfter
+//	Link "item" onto the list just after "prev", or at the front of
+//	the list if "prev" is NULL.  The item must not be on a list
+//	that uses the same link.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::InsertAfter(T prev, T item)
+{
+    ListLink<T> *l = (*link)(item);
+
+    ASSERT(l->list == NULL);
+    l->prev = prev;
+    if (prev == NULL) {			// item goes at front
+	l->next = first;
+	first = item;
+    } else {
+	l->next = (*link)(prev)->next;
+	(*link)(prev)->next = item;
+    }
+    if (l->next == NULL) {		// item goes at end
+	last = item;
+    } else {
+	(*link)(l->next)->prev = item;
+    }
+    l->list = this;
+    numInList++;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::Append, IntrusiveList<T>::Prepend
+//      Put an "item" on the end (or the front) of the list.
+//
+//	"item" is the thing to put on the list.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::Append(T item)
+{
+    InsertAfter(last, item);
+}
+
+template <class T>
+void
+IntrusiveList<T>::Prepend(T item)
+{
+    InsertAfter(NULL, item);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::RemoveFront
+//      Remove the first "item" from the front of the list.
+//	List must not be empty.
+//
+// Returns:
+//	The removed item.
+//----------------------------------------------------------------------
+
+template <class T>
+T
+IntrusiveList<T>::RemoveFront()
+{
+    T thing = first;
+
+    ASSERT(!IsEmpty());
+    Remove(thing);
+    return thing;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::Remove
+//      Remove a specific item from the list.  Must be in the list!
+//	Unlike List::Remove, there is no need to search for it.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::Remove(T item)
+{
+    ListLink<T> *l = (*link)(item);
+
+    ASSERT(IsInList(item));
+    if (l->prev == NULL) {
+	first = l->next;
+    } else {
+	(*link)(l->prev)->next = l->next;
+    }
+    if (l->next == NULL) {
+	last = l->prev;
+    } else {
+	(*link)(l->next)->prev = l->prev;
+    }
+    l->next = l->prev = NULL;
+    l->list = NULL;
+    numInList--;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList<T>::Apply
+//      Apply function to every item on a list.
+//
+//	"func" -- the function to apply
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::Apply(void (*func)(T)) const
+{
+    T ptr, next;
+
+    for (ptr = first; ptr != NULL; ptr = next) {
+	next = (*link)(ptr)->next;	// in case func takes ptr off
+        (*func)(ptr);
+    }
+}
+
+//----------------------------------------------------------------------
+// IntrusiveSortedList::Insert
+//      Insert an "item" into a list, so that the list elements are
+//	sorted in increasing order.
+//
+//	Walk back from the end of the list to the last item no bigger
+//	than the new one, and put the new item after it.  That keeps
+//	equal items in arrival order, as a SortedList does, and finds
+//	the place right away for the common cases: an interrupt due
+//	after every other one, or a thread no more important than
+//	every other ready thread.
+//
+//	"item" is the thing to put on the list.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveSortedList<T>::Insert(T item)
+{
+    T ptr;
+
+    for (ptr = this->last; ptr != NULL; ptr = (*this->link)(ptr)->prev) {
+	if (compare(item, ptr) >= 0) {
+	    break;
+	}
+    }
+    this->InsertAfter(ptr, item);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList::SanityCheck
+//      Test whether this is still a legal list.
+//
+//	Tests: do I get to last starting from first, with every item
+//	       linked back to the one before it and marked as on this
+//	       list?  does the list have the right # of items?
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::SanityCheck() const
+{
+    T ptr, prev = NULL;
+    int numFound = 0;
+
+    for (ptr = first; ptr != NULL; prev = ptr, ptr = (*link)(ptr)->next) {
+	numFound++;
+	ASSERT(numFound <= numInList);	// prevent infinite loop
+	ASSERT((*link)(ptr)->prev == prev);
+	ASSERT((*link)(ptr)->list == this);
+    }
+    ASSERT(numFound == numInList);
+    ASSERT(last == prev);
+}
+
+//----------------------------------------------------------------------
+// IntrusiveList::SelfTest
+//      Test whether this module is working.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveList<T>::SelfTest(T *p, int numEntries)
+{
+    int i;
+    IntrusiveListIterator<T> *iterator = new IntrusiveListIterator<T>(this);
+
+    SanityCheck();
+    // check various ways that list is empty
+    ASSERT(IsEmpty() && (first == NULL));
+    for (; !iterator->IsDone(); iterator->Next()) {
+	ASSERTNOTREACHED();	// nothing on list
+    }
+
+    for (i = 0; i < numEntries; i++) {
+	Append(p[i]);
+	ASSERT(IsInList(p[i]));
+	ASSERT(!IsEmpty());
+    }
+    SanityCheck();
+
+    // should be able to get out everything we put in, from the middle
+    for (i = numEntries / 2; i < numEntries + numEntries / 2; i++) {
+	Remove(p[i % numEntries]);
+	ASSERT(!IsInList(p[i % numEntries]));
+	SanityCheck();
+    }
+    ASSERT(IsEmpty());
+
+    // and in order, from the front
+    for (i = 0; i < numEntries; i++) {
+	Prepend(p[numEntries - 1 - i]);
+    }
+    for (i = 0; i < numEntries; i++) {
+	ASSERT(RemoveFront() == p[i]);
+    }
+    ASSERT(IsEmpty());
+    SanityCheck();
+    delete iterator;
+}
+
+//----------------------------------------------------------------------
+// IntrusiveSortedList::SanityCheck
+//      Test whether this is still a legal sorted list.
+//
+//	Test: is the list sorted?
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveSortedList<T>::SanityCheck() const
+{
+    T prev, ptr;
+
+    IntrusiveList<T>::SanityCheck();
+    if (this->first != this->last) {
+        for (prev = this->first, ptr = (*this->link)(prev)->next;
+		ptr != NULL; prev = ptr, ptr = (*this->link)(ptr)->next) {
+            ASSERT(compare(prev, ptr) <= 0);
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// IntrusiveSortedList::SelfTest
+//      Test whether this module is working.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+IntrusiveSortedList<T>::SelfTest(T *p, int numEntries)
+{
+    int i;
+    T *q = new T[numEntries];
+
+    for (i = 0; i < numEntries; i++) {
+	Insert(p[i]);
+	ASSERT(this->IsInList(p[i]));
+    }
+    SanityCheck();
+
+    // should be able to get out everything we put in
+    for (i = 0; i < numEntries; i++) {
+	q[i] = this->RemoveFront();
+	ASSERT(!this->IsInList(q[i]));
+    }
+    ASSERT(this->IsEmpty());
+
+    // make sure everything came out in the right order
+    for (i = 0; i < (numEntries - 1); i++) {
+	ASSERT(compare(q[i], q[i + 1]) <= 0);
+    }
+    SanityCheck();
+
+    delete [] q;
+}
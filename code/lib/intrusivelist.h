@@ -0,0 +1,162 @@
+// intrusivelist.h
+//	Data structures to manage lists whose links live in the items
+//	themselves.
+//
+//	A List allocates a ListElement for every item put on it, and
+//	frees it when the item comes off.  The ready queues, semaphore
+//	queues and pending interrupts do that on every context switch
+//	and every interrupt.  An IntrusiveList has the same interface,
+//	but each item carries its own ListLink, so putting an item on a
+//	list and taking it off never allocate anything.  The links are
+//	doubly linked, so IsInList and Remove are O(1) as well.
+//
+//	The catch is that an item can be on only one list per link it
+//	carries.  An item that has to be on two lists at once (a thread
+//	waiting for a lock is on the lock's list of waiters and on its
+//	semaphore's queue) needs a link for each.
+//
+//	Allocation and deallocation of the items on the list are to be
+//	done by the caller.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef INTRUSIVELIST_H
+#define INTRUSIVELIST_H
+
+#include "copyright.h"
+#include "debug.h"
+
+template <class T> class IntrusiveList;
+template <class T> class IntrusiveListIterator;
+
+// The following class defines a "list link" -- the part of an item
+// that keeps track of where the item is on a list.  T is a pointer
+// to the class the link is embedded in.
+//
+// The fields are private to the list module.  Made public for
+// notational convenience.
+
+template <class T>
+class ListLink {
+  public:
+    ListLink() { next = prev = NULL; list = NULL; }
+				// initialize a link, on no list
+
+    T next;			// next item on the list, NULL if last
+    T prev;			// previous item, NULL if first
+    IntrusiveList<T> *list;	// the list the item is on, NULL if none
+};
+
+// The following class defines an "intrusive list" -- a doubly linked
+// list of items, each of which has a ListLink embedded in it.  The
+// list is given a "Link" function, which returns where an item keeps
+// the link the list is to use:
+//	   ListLink<T> *Link(T x)
+// (like the "Index" function of a Heap).
+
+template <class T>
+class IntrusiveList {
+  public:
+    IntrusiveList(ListLink<T> *(*lnk)(T x));
+				// initialize the list
+    virtual ~IntrusiveList();	// de-allocate the list
+
+    virtual void Prepend(T item);// Put item at the beginning of the list
+    virtual void Append(T item); // Put item at the end of the list
+
+    T Front() { ASSERT(!IsEmpty()); return first; }
+    				// Return first item on list
+				// without removing it
+    T RemoveFront(); 		// Take item off the front of the list
+    void Remove(T item); 	// Remove specific item from list
+
+    bool IsInList(T item) const { return (*link)(item)->list == this; }
+    				// is the item in the list?
+
+    unsigned int NumInList() { return numInList; }
+    				// how many items in the list?
+    bool IsEmpty() { return (numInList == 0); }
+    				// is the list empty?
+
+    void Apply(void (*f)(T)) const;
+    				// apply function to all elements in list
+
+    virtual void SanityCheck() const;
+				// has this list been corrupted?
+    void SelfTest(T *p, int numEntries);
+				// verify module is working
+
+  protected:
+    T first;			// Head of the list, NULL if list is empty
+    T last;			// Last item on the list
+    int numInList;		// number of items on the list
+    ListLink<T> *(*link)(T x);	// where an item keeps its link
+
+    void InsertAfter(T prev, T item);
+    				// put item after prev, or at the front
+				// if prev is NULL
+
+    friend class IntrusiveListIterator<T>;
+};
+
+// The following class defines a "sorted intrusive list", arranged so
+// that RemoveFront always returns the smallest item.  As for a
+// SortedList, a "Compare" function orders the items:
+//	   int Compare(T x, T y)
+//		returns -1 if x < y
+//		returns 0 if x == y
+//		returns 1 if x > y
+// Items that compare equal stay in the order they were inserted.
+
+template <class T>
+class IntrusiveSortedList : public IntrusiveList<T> {
+  public:
+    IntrusiveSortedList(ListLink<T> *(*lnk)(T x), int (*comp)(T x, T y))
+	: IntrusiveList<T>(lnk) { compare = comp; }
+    ~IntrusiveSortedList() {}	// base class destructor called automatically
+
+    void Insert(T item); 	// insert an item onto the list in sorted order
+
+    void SanityCheck() const;	// has this list been corrupted?
+    void SelfTest(T *p, int numEntries);
+				// verify module is working
+
+  private:
+    int (*compare)(T x, T y);	// function for sorting list elements
+
+    void Prepend(T item) { Insert(item); }  // *pre*pending has no meaning
+				             //	in a sorted list
+    void Append(T item) { Insert(item); }   // neither does *ap*pend
+};
+
+// The following class can be used to step through an intrusive list,
+// exactly as a ListIterator steps through a List.  The current item
+// must not be removed from the list while the iterator is on it.
+
+template <class T>
+class IntrusiveListIterator {
+  public:
+    IntrusiveListIterator(IntrusiveList<T> *list)
+	{ current = list->first; link = list->link; }
+				// initialize an iterator
+
+    bool IsDone() { return current == NULL; }
+				// return TRUE if we are at the end of the list
+
+    T Item() { ASSERT(!IsDone()); return current; }
+				// return current element on list
+
+    void Next() { current = (*link)(current)->next; }
+				// update iterator to point to next
+
+  private:
+    T current;			// where we are in the list
+    ListLink<T> *(*link)(T x);	// where items keep their links
+};
+
+#include "intrusivelist.cc"	// templates are really like macros
+				// so needs to be included in every
+				// file that uses the template
+#endif // INTRUSIVELIST_H
@@ -1,6 +1,7 @@
 // libtest.cc 
 //	Driver code to call self-test routines for standard library
-//	classes -- bitmaps, lists, sorted lists, and hash tables.
+//	classes -- bitmaps, lists, sorted lists, intrusive lists, heaps,
+//	and hash tables.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -10,6 +11,8 @@
 #include "libtest.h"
 #include "bitmap.h"
 #include "list.h"
+#include "intrusivelist.h"
+#include "heap.h"
 #include "hash.h"
 #include "sysdep.h"
 
@@ -26,6 +29,112 @@ IntCompare(int x, int y) {
     else return 1;
 }
 
+//----------------------------------------------------------------------
+// LinkedInt, IntLink, LinkedIntCompare
+//	An integer that carries its own list link, the link function to
+//	find it, and the comparison function to sort on the integer.
+//	For testing IntrusiveLists.
+//----------------------------------------------------------------------
+
+class LinkedInt {
+  public:
+    int value;
+    ListLink<LinkedInt *> link;
+};
+
+static ListLink<LinkedInt *> *
+IntLink(LinkedInt *x) {
+    return &x->link;
+}
+
+static int 
+LinkedIntCompare(LinkedInt *x, LinkedInt *y) {
+    return IntCompare(x->value, y->value);
+}
+
+//----------------------------------------------------------------------
+// IndexedInt, IntIndex, IndexedIntCompare
+//	An integer that keeps track of its own heap position, the index
+//	function to find it, and the comparison function to order on
+//	the integer.  For testing indexed Heaps.
+//----------------------------------------------------------------------
+
+class IndexedInt {
+  public:
+    int value;
+    int index;
+};
+
+static int *
+IntIndex(IndexedInt *x) {
+    return &x->index;
+}
+
+static int 
+IndexedIntCompare(IndexedInt *x, IndexedInt *y) {
+    return IntCompare(x->value, y->value);
+}
+
+//----------------------------------------------------------------------
+// IndexedHeapTest
+//	Test the parts of a Heap that only an indexed heap exercises:
+//	changing keys in place with Update, and Remove from the middle
+//	without a search.  "values" are the keys to start with.
+//----------------------------------------------------------------------
+
+static void
+IndexedHeapTest(int *values, int numEntries)
+{
+    Heap<IndexedInt *> *heap = new Heap<IndexedInt *>(IndexedIntCompare,
+							IntIndex);
+    IndexedInt *items = new IndexedInt[numEntries];
+    IndexedInt *prev = NULL;
+    int i;
+
+    for (i = 0; i < numEntries; i++) {
+	items[i].value = values[i];
+	items[i].index = -1;
+	heap->Insert(&items[i]);
+	ASSERT(items[i].index >= 0);
+    }
+    heap->SanityCheck();
+
+    // move every other item: the even ones towards the front, the
+    // odd ones towards the back
+    for (i = 0; i < numEntries; i++) {
+	items[i].value += (i % 2 == 0) ? -100 : 100;
+	heap->Update(&items[i]);
+	heap->SanityCheck();
+    }
+    ASSERT(heap->Front()->value < 0);
+
+    // take out whatever is in the middle of the heap, until only
+    // a quarter is left
+    while (heap->NumInList() > (unsigned int) numEntries / 4) {
+	for (i = 0; items[i].index != (int) heap->NumInList() / 2; i++) {
+	    ASSERT(i < numEntries - 1);
+	}
+	heap->Remove(&items[i]);
+	ASSERT(items[i].index == -1);
+	ASSERT(!heap->IsInList(&items[i]));
+	heap->SanityCheck();
+    }
+
+    // the rest should come out sorted, with no positions left behind
+    while (!heap->IsEmpty()) {
+	IndexedInt *item = heap->RemoveFront();
+
+	ASSERT(item->index == -1);
+	ASSERT(prev == NULL || prev->value <= item->value);
+	prev = item;
+    }
+    for (i = 0; i < numEntries; i++) {
+	ASSERT(items[i].index == -1);
+    }
+    delete heap;
+    delete [] items;
+}
+
 //----------------------------------------------------------------------
 // HashInt, HashKey
 //	Compute a hash function on an integer.  Serves as the
@@ -53,6 +162,11 @@ HashKey(char *str) {
 // Array of values to be inserted into a List or SortedList. 
 static int listTestVector[] = { 9, 5, 7 };
 
+// Array of values to be inserted into a Heap.  Long enough that
+// the heap has to grow.
+static int heapTestVector[] = { 21, 9, 5, 7, 30, 2, 18, 11, 4, 27, 1, 16,
+	 13, 8, 24, 3, 19, 6, 29, 12 };
+
 // Array of values to be inserted into the HashTable
 // There are enough here to force a ReHash().
 static char *hashTestVector[] = { "0", "1", "2", "3", "4", "5", "6",
@@ -60,15 +174,23 @@ static char *hashTestVector[] = { "0", "1", "2", "3", "4", "5", "6",
 
 //----------------------------------------------------------------------
 // LibSelfTest
-//	Run self tests on bitmaps, lists, sorted lists, and 
-//	hash tables.
+//	Run self tests on bitmaps, lists, sorted lists, intrusive lists,
+//	heaps, and hash tables.
 //----------------------------------------------------------------------
 
 void
 LibSelfTest () {
+    const int numLinked = sizeof(heapTestVector)/sizeof(int);
     Bitmap *map = new Bitmap(200);
     List<int> *list = new List<int>;
     SortedList<int> *sortList = new SortedList<int>(IntCompare);
+    IntrusiveList<LinkedInt *> *linkList = 
+	new IntrusiveList<LinkedInt *>(IntLink);
+    IntrusiveSortedList<LinkedInt *> *linkSortList = 
+	new IntrusiveSortedList<LinkedInt *>(IntLink, LinkedIntCompare);
+    LinkedInt linked[numLinked];
+    LinkedInt *linkedVector[numLinked];
+    Heap<int> *heap = new Heap<int>(IntCompare);
     HashTable<int, char *> *hashTable = 
 	new HashTable<int, char *>(HashKey, HashInt);
 	
@@ -76,10 +198,21 @@ LibSelfTest () {
     map->SelfTest();
     list->SelfTest(listTestVector, sizeof(listTestVector)/sizeof(int));
     sortList->SelfTest(listTestVector, sizeof(listTestVector)/sizeof(int));
+    for (int i = 0; i < numLinked; i++) {
+	linked[i].value = heapTestVector[i];
+	linkedVector[i] = &linked[i];
+    }
+    linkList->SelfTest(linkedVector, numLinked);
+    linkSortList->SelfTest(linkedVector, numLinked);
+    heap->SelfTest(heapTestVector, sizeof(heapTestVector)/sizeof(int));
+    IndexedHeapTest(heapTestVector, sizeof(heapTestVector)/sizeof(int));
     hashTable->SelfTest(hashTestVector, sizeof(hashTestVector)/sizeof(char *));
 
     delete map;
     delete list;
     delete sortList;
+    delete linkList;
+    delete linkSortList;
+    delete heap;
     delete hashTable;
 }
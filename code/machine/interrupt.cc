@@ -23,6 +23,8 @@
 #include "copyright.h"
 #include "interrupt.h"
 #include "main.h"
+#include "workqueue.h"
+#include "lockprof.h"
 
 // String definitions for debugging messages
 
@@ -62,6 +64,17 @@ PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
     else { return 0; }
 }
 
+//----------------------------------------------------------------------
+// PendingLink
+//	Where a pending interrupt keeps its place on the pending list.
+//----------------------------------------------------------------------
+
+static ListLink<PendingInterrupt *> *
+PendingLink (PendingInterrupt *x)
+{
+    return &x->link;
+}
+
 //----------------------------------------------------------------------
 // Interrupt::Interrupt
 // 	Initialize the simulation of hardware device interrupts.
@@ -72,7 +85,8 @@ PendingCompare (PendingInterrupt *x, PendingInterrupt *y)
 Interrupt::Interrupt()
 {
     level = IntOff;
-    pending = new SortedList<PendingInterrupt *>(PendingCompare);
+    pending = new IntrusiveSortedList<PendingInterrupt *>(PendingLink,
+							  PendingCompare);
     inHandler = FALSE;
     yieldOnReturn = FALSE;
     status = SystemMode;
@@ -175,6 +189,50 @@ Interrupt::OneTick()
     }
 }
 
+//----------------------------------------------------------------------
+// Interrupt::RunFor
+// 	Advance simulated time by "ticks" of (user-level) computation
+//	by the current thread, as if it had executed that many user
+//	instructions -- but without simulating them.  Used to replay
+//	recorded CPU bursts.
+//
+//	Rather than one tick at a time, the clock jumps straight to the
+//	next pending interrupt (or the end of the burst), so a burst
+//	costs one step per interrupt instead of one per tick.  If an
+//	interrupt handler asks for a context switch, we switch, and
+//	carry on with the rest of the burst when we get the CPU back.
+//----------------------------------------------------------------------
+
+void
+Interrupt::RunFor(int ticks)
+{
+    Statistics *stats = kernel->stats;
+    int step;
+
+    ASSERT(level == IntOn);
+    while (ticks > 0) {
+	step = ticks;
+	if (!pending->IsEmpty() &&
+	    pending->Front()->when - stats->totalTicks < step) {
+	    step = pending->Front()->when - stats->totalTicks;
+	    if (step < UserTick) {
+		step = UserTick;
+	    }
+	}
+	stats->totalTicks += step;
+	stats->userTicks += step;
+	ticks -= step;
+
+	ChangeLevel(IntOn, IntOff);	// as in OneTick
+	CheckIfDue(FALSE);
+	ChangeLevel(IntOff, IntOn);
+	if (yieldOnReturn) {
+	    yieldOnReturn = FALSE;
+	    kernel->currentThread->Yield();
+	}
+    }
+}
+
 //----------------------------------------------------------------------
 // Interrupt::YieldOnReturn
 // 	Called from within an interrupt handler, to cause a context switch
@@ -239,6 +297,11 @@ Interrupt::Halt()
     cout << "Machine halting!\n\n";
     cout << "This is halt\n";
     kernel->stats->Print();
+    kernel->scheduler->PrintStats();
+    kernel->workQueue->PrintStats();
+    if (kernel->lockProfiler != NULL) {
+	kernel->lockProfiler->Print();
+    }
     delete kernel;	// Never returns.
 }
 /*
@@ -306,6 +369,28 @@ Interrupt::Schedule(CallBackObj *toCall, int fromNow, IntType type)
     pending->Insert(toOccur);
 }
 
+//----------------------------------------------------------------------
+// Interrupt::Cancel
+// 	Take every pending interrupt that would call "toCall" off the
+//	list, as if the device had been told to stop.  Used by the timer,
+//	to be re-armed with a different delay.
+//----------------------------------------------------------------------
+void
+Interrupt::Cancel(CallBackObj *toCall)
+{
+    IntrusiveListIterator<PendingInterrupt *> iter(pending);
+    PendingInterrupt *next;
+
+    while (!iter.IsDone()) {
+	next = iter.Item();
+	iter.Next();			// before next comes off the list
+	if (next->callOnInterrupt == toCall) {
+	    pending->Remove(next);
+	    delete next;
+	}
+    }
+}
+
 //----------------------------------------------------------------------
 // Interrupt::CheckIfDue
 // 	Check if any interrupts are scheduled to occur, and if so, 
@@ -35,6 +35,7 @@
 
 #include "copyright.h"
 #include "list.h"
+#include "intrusivelist.h"
 #include "callback.h"
 
 // Interrupts can be disabled (IntOff) or enabled (IntOn)
@@ -68,6 +69,8 @@ class PendingInterrupt {
     
     int when;			// When the interrupt is supposed to fire
     IntType type;		// for debugging
+    ListLink<PendingInterrupt *> link;
+    				// on the list of pending interrupts
 };
 
 // The following class defines the data structures for the simulation
@@ -110,6 +113,8 @@ class Interrupt {
     MachineStatus getStatus() { return status; } 
     void setStatus(MachineStatus st) { status = st; }
         			// idle, kernel, user
+    bool InHandler() { return inHandler; }
+    				// running an interrupt handler?
 
     void DumpState();		// Print interrupt state
     
@@ -124,11 +129,16 @@ class Interrupt {
 				// at time "when".  This is called
     				// by the hardware device simulators.
     
+    void Cancel(CallBackObj *callTo);
+    				// Forget the pending interrupts that
+				// would call "callTo"
     void OneTick();       	// Advance simulated time
+    void RunFor(int ticks);	// Advance simulated time by "ticks"
+				// of computation by the current thread
 
   private:
     IntStatus level;		// are interrupts enabled or disabled?
-    SortedList<PendingInterrupt *> *pending;		
+    IntrusiveSortedList<PendingInterrupt *> *pending;		
     				// the list of interrupts scheduled
 				// to occur in the future
     //int writeFileNo;            //UNIX file emulating the display
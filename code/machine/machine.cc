@@ -72,6 +72,8 @@ Machine::Machine(bool debug)
 #endif
 
     singleStep = debug;
+    linked = FALSE;
+    linkAddress = 0;
     CheckEndian();
 }
 
@@ -103,6 +105,7 @@ Machine::RaiseException(ExceptionType which, int badVAddr)
     DEBUG(dbgMach, "Exception: " << exceptionNames[which]);
     registers[BadVAddrReg] = badVAddr;
     DelayedLoad(0, 0);			// finish anything in progress
+    linked = FALSE;			// the kernel runs; break any LL/SC
     kernel->interrupt->setStatus(SystemMode);
     ExceptionHandler(which);		// interrupts are enabled at this point
     kernel->interrupt->setStatus(UserMode);
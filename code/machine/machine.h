@@ -106,6 +106,10 @@ class Machine {
     void WriteRegister(int num, int value);
 				// store a value into a CPU register
 
+    void ClearLink() { linked = FALSE; }
+    				// make the next SC fail; called when
+				// another user thread gets the CPU
+
 // Data structures accessible to the Nachos kernel -- main memory and the
 // page table/TLB.
 //
@@ -173,6 +177,9 @@ class Machine {
 // Internal data structures
 
     int registers[NumTotalRegs]; // CPU registers, for executing user programs
+    bool linked;		// has there been an LL, with nothing
+    				// else running on the CPU since?
+    int linkAddress;		// if so, the address it loaded
 
     bool singleStep;		// drop back into the debugger after each
 				// simulated instruction
@@ -312,6 +312,21 @@ Machine::OneInstruction(Instruction *instr)
 	nextLoadValue = value;
 	break;
     	
+      case OP_LL:
+	// as LW, but remember the address, for a following SC
+	tmp = registers[instr->rs] + instr->extra;
+	if (tmp & 0x3) {
+	    RaiseException(AddressErrorException, tmp);
+	    return;
+	}
+	if (!ReadMem(tmp, 4, &value))
+	    return;
+	linked = TRUE;
+	linkAddress = tmp;
+	nextLoadReg = instr->rt;
+	nextLoadValue = value;
+	break;
+    	
       case OP_LWL:	  
 	tmp = registers[instr->rs] + instr->extra;
 
@@ -552,6 +567,24 @@ Machine::OneInstruction(Instruction *instr)
 	    return;
 	break;
 	
+      case OP_SC:
+	// store only if nothing has run on this CPU since the LL;
+	// rt says whether it did
+	tmp = registers[instr->rs] + instr->extra;
+	if (tmp & 0x3) {
+	    RaiseException(AddressErrorException, tmp);
+	    return;
+	}
+	if (linked && linkAddress == tmp) {
+	    if (!WriteMem(tmp, 4, registers[instr->rt]))
+		return;
+	    registers[instr->rt] = 1;
+	} else {
+	    registers[instr->rt] = 0;
+	}
+	linked = FALSE;
+	break;
+	
       case OP_SWL:	  
 	tmp = registers[instr->rs] + instr->extra;
 
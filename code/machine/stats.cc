@@ -22,6 +22,100 @@ Statistics::Statistics()
     numDiskReads = numDiskWrites = 0;
     numConsoleCharsRead = numConsoleCharsWritten = 0;
     numPageFaults = numPacketsSent = numPacketsRecvd = 0;
+    numInversions = inversionTicks = maxInversionTicks = 0;
+    numWakeBoosts = wakeBoostPoints = 0;
+    stackBytes = peakStackBytes = stackAllocs = stackReuses = 0;
+    userStateSaves = userStateLoads = userStateSkips = 0;
+    numFutexWaits = numFutexWakes = 0;
+    threadTimes = new List<ThreadTimes *>;
+    groupUsage = new List<GroupUsage *>;
+}
+
+//----------------------------------------------------------------------
+// Statistics::~Statistics
+// 	De-allocate the thread records.
+//----------------------------------------------------------------------
+
+Statistics::~Statistics()
+{
+    while (!threadTimes->IsEmpty()) {
+	delete threadTimes->RemoveFront();
+    }
+    delete threadTimes;
+    while (!groupUsage->IsEmpty()) {
+	delete groupUsage->RemoveFront();
+    }
+    delete groupUsage;
+}
+
+//----------------------------------------------------------------------
+// ThreadTimes::ThreadTimes
+// 	Start the record of a thread that arrived at "arrivalTime".
+//----------------------------------------------------------------------
+
+ThreadTimes::ThreadTimes(int threadID, char *threadName, int arrivalTime)
+{
+    id = threadID;
+    name = threadName;
+    arrival = arrivalTime;
+    firstRun = -1;
+    readyWait = 0;
+    readySince = -1;
+    switches = 0;
+    completion = -1;
+}
+
+//----------------------------------------------------------------------
+// GroupUsage::GroupUsage
+// 	Start the record of a process group, with no threads yet.
+//----------------------------------------------------------------------
+
+GroupUsage::GroupUsage(int groupID, char *groupName, int cpuShare,
+		       int cpuQuota)
+{
+    id = groupID;
+    name = groupName;
+    share = cpuShare;
+    quota = cpuQuota;
+    threads = 0;
+    cpuTicks = 0;
+    throttles = 0;
+    throttledTicks = 0;
+}
+
+//----------------------------------------------------------------------
+// Statistics::NewThread
+// 	Start recording the life of a thread.  The record is kept (for
+//	Print) after the thread is gone.
+//
+// Returns:
+//	The new record.
+//----------------------------------------------------------------------
+
+ThreadTimes *
+Statistics::NewThread(int threadID, char *threadName, int arrival)
+{
+    ThreadTimes *times = new ThreadTimes(threadID, threadName, arrival);
+
+    threadTimes->Append(times);
+    return times;
+}
+
+//----------------------------------------------------------------------
+// Statistics::NewGroup
+// 	Start recording the CPU use of a process group.
+//
+// Returns:
+//	The new record.
+//----------------------------------------------------------------------
+
+GroupUsage *
+Statistics::NewGroup(int groupID, char *groupName, int share, int quota)
+{
+    GroupUsage *usage = new GroupUsage(groupID, groupName, share, quota);
+
+    groupUsage->Append(usage);
+    return usage;
 }
 
 //----------------------------------------------------------------------
@@ -42,4 +136,159 @@ Statistics::Print()
     cout << "Paging: faults " << numPageFaults << "\n";
     cout << "Network I/O: packets received " << numPacketsRecvd;
 		cout << ", sent " << numPacketsSent << "\n";
+    cout << "Priority inversions: " << numInversions;
+    cout << ", ticks blocked " << inversionTicks;
+    cout << ", longest " << maxInversionTicks << "\n";
+    cout << "Wake boosts: " << numWakeBoosts;
+    cout << ", priority added " << wakeBoostPoints << "\n";
+    cout << "Thread stacks: bytes " << stackBytes;
+    cout << ", peak " << peakStackBytes << ", allocated " << stackAllocs;
+    cout << ", reused " << stackReuses << "\n";
+    cout << "User state: saves " << userStateSaves;
+    cout << ", loads " << userStateLoads;
+    cout << ", skipped " << userStateSkips << "\n";
+    cout << "Futexes: waits " << numFutexWaits;
+    cout << ", wakes " << numFutexWakes << "\n";
+    PrintThreads();
+    PrintGroups();
+}
+
+//----------------------------------------------------------------------
+// Percentile
+// 	Return the "p"th percentile (nearest rank) of the "n" values
+//	in "sorted", which must be in increasing order.
+//----------------------------------------------------------------------
+
+static int
+Percentile(int *sorted, int n, int p)
+{
+    int rank = (p * n + 99) / 100;	// ceiling of p% of n
+
+    if (rank < 1) {
+	rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+//----------------------------------------------------------------------
+// CompareValues
+//	Compare two of the values to be sorted, for qsort.
+//----------------------------------------------------------------------
+
+static int
+CompareValues(const void *x, const void *y)
+{
+    int a = *(const int *) x;
+    int b = *(const int *) y;
+
+    if (a < b) return -1;
+    else if (a == b) return 0;
+    else return 1;
+}
+
+//----------------------------------------------------------------------
+// PrintDistribution
+// 	Sort the "n" values in "values" and print their p50/p95/p99
+//	and maximum.  There is a value per thread, and there may be
+//	thousands of threads, so use qsort.
+//----------------------------------------------------------------------
+
+static void
+PrintDistribution(char *what, int *values, int n)
+{
+    if (n == 0) {
+	return;
+    }
+    qsort(values, n, sizeof(int), CompareValues);
+    cout << what << ": p50 " << Percentile(values, n, 50);
+    cout << ", p95 " << Percentile(values, n, 95);
+    cout << ", p99 " << Percentile(values, n, 99);
+    cout << ", max " << values[n - 1] << " (" << n << " threads)\n";
+}
+
+//----------------------------------------------------------------------
+// Statistics::PrintThreads
+// 	Print the life of every thread, the distribution of the
+//	response, ready-wait and turnaround times, and the throughput
+//	(threads finished per 1000 ticks).  Threads that never
+//	ran (or never finished) are left out of the distributions they
+//	have no value for.
+//----------------------------------------------------------------------
+
+void
+Statistics::PrintThreads()
+{
+    ListIterator<ThreadTimes *> iter(threadTimes);
+    ThreadTimes *t;
+    int n = threadTimes->NumInList();
+    int *response, *wait, *turnaround;
+    int numResponse = 0, numWait = 0, numTurnaround = 0;
+
+    if (n == 0) {
+	return;
+    }
+    response = new int[n];
+    wait = new int[n];
+    turnaround = new int[n];
+
+    cout << "Thread\tArrive\tFirst\tWait\tSwitch\tFinish\tName\n";
+    for (; !iter.IsDone(); iter.Next()) {
+	t = iter.Item();
+	cout << t->id << "\t" << t->arrival << "\t" << t->firstRun << "\t"
+	     << t->readyWait << "\t" << t->switches << "\t"
+	     << t->completion << "\t" << t->name << "\n";
+	wait[numWait++] = t->readyWait;
+	if (t->firstRun >= 0) {
+	    response[numResponse++] = t->Response();
+	}
+	if (t->completion >= 0) {
+	    turnaround[numTurnaround++] = t->Turnaround();
+	}
+    }
+    PrintDistribution("Response", response, numResponse);
+    PrintDistribution("Ready wait", wait, numWait);
+    PrintDistribution("Turnaround", turnaround, numTurnaround);
+    if (numTurnaround > 0 && totalTicks > 0) {
+	cout << "Throughput: " << numTurnaround << " threads finished in "
+	     << totalTicks << " ticks, "
+	     << (1000.0 * numTurnaround) / totalTicks << " per 1000 ticks\n";
+    }
+
+    delete [] response;
+    delete [] wait;
+    delete [] turnaround;
+}
+
+//----------------------------------------------------------------------
+// Statistics::PrintGroups
+// 	Print the CPU use of every process group, as ticks and as a
+//	fraction of all the CPU the groups used, next to the share each
+//	was meant to get.
+//----------------------------------------------------------------------
+
+void
+Statistics::PrintGroups()
+{
+    ListIterator<GroupUsage *> total(groupUsage);
+    ListIterator<GroupUsage *> iter(groupUsage);
+    GroupUsage *g;
+    int shares = 0, cpu = 0;
+
+    if (groupUsage->IsEmpty()) {
+	return;
+    }
+    for (; !total.IsDone(); total.Next()) {
+	shares += total.Item()->share;
+	cpu += total.Item()->cpuTicks;
+    }
+    cout << "Group\tShare\tQuota\tThreads\tCPU\tUsed%\tThrottle"
+	 << "\tHeld\tName\n";
+    for (; !iter.IsDone(); iter.Next()) {
+	g = iter.Item();
+	cout << g->id << "\t" << (100.0 * g->share) / shares << "%\t"
+	     << g->quota << "\t" << g->threads << "\t" << g->cpuTicks << "\t"
+	     << (cpu > 0 ? (100.0 * g->cpuTicks) / cpu : 0) << "%\t"
+	     << g->throttles << "\t" << g->throttledTicks << "\t"
+	     << g->name << "\n";
+    }
 }
@@ -12,6 +12,50 @@
 #define STATS_H
 
 #include "copyright.h"
+#include "list.h"
+
+// The following class records the life of one thread, as seen by
+// the scheduler: when it arrived (was first made ready), when it
+// first ran, how long it waited on the ready list in all, how many
+// times it was dispatched, and when it finished.  Times are in ticks;
+// -1 means "not yet".
+
+class ThreadTimes {
+  public:
+    ThreadTimes(int threadID, char *threadName, int arrivalTime);
+
+    int id;			// the thread's ID
+    char *name;			// the thread's name
+    int arrival;		// first made ready
+    int firstRun;		// first dispatched
+    int readyWait;		// total time on the ready list
+    int readySince;		// when it was last made ready,
+				// -1 if not on the ready list
+    int switches;		// number of times dispatched
+    int completion;		// finished
+
+    int Response() { return firstRun - arrival; }
+    int Turnaround() { return completion - arrival; }
+};
+
+// The following class records what became of a process group (see
+// procgroup.h): its share and quota, how much CPU its threads used,
+// and how often, and for how long, they were held back for going
+// over them.
+
+class GroupUsage {
+  public:
+    GroupUsage(int groupID, char *groupName, int cpuShare, int cpuQuota);
+
+    int id;			// the group's ID
+    char *name;			// the group's name
+    int share;			// relative CPU share
+    int quota;			// most CPU ticks per window, 0 if none
+    int threads;		// threads that ever belonged to it
+    int cpuTicks;		// CPU ticks its threads used
+    int throttles;		// times a thread was held back
+    int throttledTicks;		// total time threads were held back
+};
 
 // The following class defines the statistics that are to be kept
 // about Nachos behavior -- how much time (ticks) elapsed, how
@@ -35,10 +79,41 @@ class Statistics {
     int numPageFaults;		// number of virtual memory page faults
     int numPacketsSent;		// number of packets sent over the network
     int numPacketsRecvd;	// number of packets received over the network
+    int numInversions;		// number of times a thread blocked on a
+				// lock held by a lower priority thread
+    int inversionTicks;		// total time blocked that way
+    int maxInversionTicks;	// longest time blocked that way
+    int numWakeBoosts;		// number of times a thread woken by
+				// I/O had its priority raised
+    int wakeBoostPoints;	// total priority added that way
+    int stackBytes;		// memory in thread stacks now
+    int peakStackBytes;		// most memory in thread stacks
+    int stackAllocs;		// stacks allocated from the host
+    int stackReuses;		// stacks recycled from the pool
+    int userStateSaves;		// user registers copied out of the machine
+    int userStateLoads;		// user registers copied into the machine
+    int userStateSkips;		// context switches back to the user
+				// program whose registers were still there
+    int numFutexWaits;		// user threads that slept on a futex
+    int numFutexWakes;		// and that were woken up
+
+    List<ThreadTimes *> *threadTimes;	// life of every thread, in
+				// order of arrival
+    List<GroupUsage *> *groupUsage;	// every process group that had
+				// a thread
 
     Statistics(); 		// initialize everything to zero
+    ~Statistics();		// de-allocate the thread records
 
+    ThreadTimes *NewThread(int threadID, char *threadName, int arrival);
+    				// start recording the life of a thread
+    GroupUsage *NewGroup(int groupID, char *groupName, int share, int quota);
+    				// start recording a process group
     void Print();		// print collected statistics
+
+  private:
+    void PrintThreads();	// per-thread rows, and percentiles
+    void PrintGroups();		// per-group CPU use
 };
 
 // Constants used to reflect the relative time an operation would
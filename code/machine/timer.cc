@@ -40,6 +40,7 @@ Timer::Timer(bool doRandom, CallBackObj *toCall)
     randomize = doRandom;
     callPeriodically = toCall;
     disable = FALSE;
+    period = TimerTicks;
     SetInterrupt();
 }
 
@@ -70,7 +71,7 @@ void
 Timer::SetInterrupt() 
 {
     if (!disable) {
-       int delay = TimerTicks;
+       int delay = period;
     
        if (randomize) {
 	     delay = 1 + (RandomNumber() % (TimerTicks * 2));
@@ -79,3 +80,21 @@ Timer::SetInterrupt()
        kernel->interrupt->Schedule(this, delay, TimerInt);
     }
 }
+
+//----------------------------------------------------------------------
+// Timer::Rearm
+//      Change the time between interrupts to "ticks", and start over:
+//	the next interrupt is "ticks" from now.  Random delays, if
+//	asked for, stay random.
+//----------------------------------------------------------------------
+
+void
+Timer::Rearm(int ticks)
+{
+    ASSERT(ticks > 0);
+    period = ticks;
+    if (!disable && !randomize) {
+	kernel->interrupt->Cancel(this);
+	SetInterrupt();
+    }
+}
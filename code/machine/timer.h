@@ -35,12 +35,16 @@ class Timer : public CallBackObj {
     void Disable() { disable = TRUE; }
     				// Turn timer device off, so it doesn't
 				// generate any more interrupts.
+    void Rearm(int ticks);	// From now on, interrupt every "ticks"
+				// time units, starting "ticks" from now
 
   private:
     bool randomize;		// set if we need to use a random timeout delay
     CallBackObj *callPeriodically; // call this every TimerTicks time units 
     bool disable;		// turn off the timer device after next
     				// interrupt.
+    int period;			// time between interrupts (unless
+				// randomized)
     
     void CallBack();		// called internally when the hardware
 				// timer generates an interrupt
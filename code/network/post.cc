@@ -18,6 +18,7 @@
 
 #include "copyright.h"
 #include "post.h"
+#include "workqueue.h"
 
 //----------------------------------------------------------------------
 // Mail::Mail
@@ -49,7 +50,7 @@ Mail::Mail(PacketHeader pktH, MailHeader mailH, char *msgData)
 
 MailBox::MailBox()
 { 
-    messages = new SynchList<Mail *>(); 
+    messages = new SynchList<Mail *>(MailBoxSize); 
 }
 
 //----------------------------------------------------------------------
@@ -84,7 +85,9 @@ PrintHeader(PacketHeader pktHdr, MailHeader mailHdr)
 //----------------------------------------------------------------------
 // MailBox::Put
 // 	Add a message to the mailbox.  If anyone is waiting for message
-//	arrival, wake them up!
+//	arrival, wake them up!  If the mailbox is full, drop the message:
+//	this runs on the post office's worker, which must not wait for
+//	a reader.
 //
 //	We need to reconstruct the Mail message (by concatenating the headers
 //	to the data), to simplify queueing the message on the SynchList.
@@ -99,9 +102,12 @@ MailBox::Put(PacketHeader pktHdr, MailHeader mailHdr, char *data)
 { 
     Mail *mail = new Mail(pktHdr, mailHdr, data); 
 
-    messages->Append(mail);		// put on the end of the list of 
+    if (!messages->TryAppend(mail)) {	// put on the end of the list of 
 					// arrived messages, and wake up 
 					// any waiters
+	DEBUG(dbgNet, "Mailbox " << mailHdr.to << " is full, dropping mail");
+	delete mail;
+    }
 }
 
 //----------------------------------------------------------------------
@@ -142,35 +148,32 @@ MailBox::Get(PacketHeader *pktHdr, MailHeader *mailHdr, char *data)
 //	Also initialize the network device, to allow post offices
 //	on different machines to deliver messages to one another.
 //
-//      We use a separate thread "the postal worker" to wait for messages 
-//	to arrive, and deliver them to the correct mailbox.  Note that
+//      Each message that arrives is delivered to the correct mailbox
+//	by the kernel's work queue (see workqueue.h).  Note that
 //	delivering messages to the mailboxes can't be done directly
 //	by the interrupt handlers, because it requires a Lock.
 //
+//	The kernel's queue has more than one worker, and a worker can be
+//	preempted between taking a message off the network and putting
+//	it in its mailbox.  So that another worker cannot put the next
+//	message in first, only one delivery is posted at a time; it
+//	delivers every message that arrives while it runs.
+//
 //	"nBoxes" is the number of mail boxes in this Post Office
 //----------------------------------------------------------------------
 
 PostOfficeInput::PostOfficeInput(int nBoxes)
 {
-    messageAvailable = new Semaphore("message available", 0);
-
     numBoxes = nBoxes;
     boxes = new MailBox[nBoxes];
+    numPending = 0;
 
     network = new NetworkInput(this);
-
-    Thread *t = new Thread("postal worker", 1);
-
-    t->Fork(PostOfficeInput::PostalDelivery, this);
 }
 
 //----------------------------------------------------------------------
 // PostOfficeInput::~PostOfficeInput
 // 	De-allocate the post office data structures.
-//	
-//	Since the postal helper is waiting on the "messageAvail" semaphore,
-//	we don't deallocate it!  This leaves garbage lying about,
-//	but the alternative is worse!
 //----------------------------------------------------------------------
 
 PostOfficeInput::~PostOfficeInput()
@@ -181,7 +184,10 @@ PostOfficeInput::~PostOfficeInput()
 
 //----------------------------------------------------------------------
 // PostOffice::PostalDelivery
-// 	Wait for incoming messages, and put them in the right mailbox.
+// 	Put incoming messages in the right mailboxes, in the order they
+//	arrived, until none are left.  Runs on a kernel worker thread;
+//	CallBack posts it when a message arrives and no delivery is
+//	already under way.
 //
 //      Incoming messages have had the PacketHeader stripped off,
 //	but the MailHeader is still tacked on the front of the data.
@@ -193,26 +199,32 @@ PostOfficeInput::PostalDelivery(void* data)
     PostOfficeInput* _this = (PostOfficeInput*)data;
     PacketHeader pktHdr;
     MailHeader mailHdr;
-    char *buffer = new char[MaxPacketSize];
+    char buffer[MaxPacketSize];
+    IntStatus oldLevel;
+    int pending;
 
-    for (;;) {
-        // first, wait for a message
-        _this->messageAvailable->P();	
-        pktHdr = _this->network->Receive(buffer);
+    do {
+	pktHdr = _this->network->Receive(buffer);
 
-        mailHdr = *(MailHeader *)buffer;
-        if (debug->IsEnabled('n')) {
+	mailHdr = *(MailHeader *)buffer;
+	if (debug->IsEnabled('n')) {
 	    cout << "Putting mail into mailbox: ";
 	    PrintHeader(pktHdr, mailHdr);
-        }
+	}
 
 	// check that arriving message is legal!
 	ASSERT(0 <= mailHdr.to && mailHdr.to < _this->numBoxes);
 	ASSERT(mailHdr.length <= MaxMailSize);
 
 	// put into mailbox
-        _this->boxes[mailHdr.to].Put(pktHdr, mailHdr, buffer + sizeof(MailHeader));
-    }
+	_this->boxes[mailHdr.to].Put(pktHdr, mailHdr, 
+				     buffer + sizeof(MailHeader));
+
+	// did more mail arrive meanwhile?
+	oldLevel = kernel->interrupt->SetLevel(IntOff);
+	pending = --_this->numPending;
+	(void) kernel->interrupt->SetLevel(oldLevel);
+    } while (pending > 0);
 }
 
 //----------------------------------------------------------------------
@@ -244,13 +256,17 @@ PostOfficeInput::Receive(int box, PacketHeader *pktHdr,
 // PostOffice::CallBack
 // 	Interrupt handler, called when a packet arrives from the network.
 //
-//	Signal the PostalDelivery routine that it is time to get to work!
+//	Have a kernel worker run PostalDelivery, to get the message,
+//	unless a delivery is already under way; it will get this message
+//	too.
 //----------------------------------------------------------------------
 
 void
 PostOfficeInput::CallBack()
 { 
-    messageAvailable->V(); 
+    if (numPending++ == 0) {
+	kernel->workQueue->Post(PostOfficeInput::PostalDelivery, this); 
+    }
 }
 
 //----------------------------------------------------------------------
@@ -77,6 +77,12 @@ class Mail {
 // for messages.   Incoming messages are put by the PostOffice into the 
 // appropriate mailbox, and these messages can then be retrieved by
 // threads on this machine.
+//
+// A mailbox holds at most MailBoxSize messages; a message that arrives
+// when its mailbox is full is dropped, as if the network had lost it,
+// rather than holding up the delivery of messages to other mailboxes.
+
+const int MailBoxSize = 16;	// most messages waiting in a mailbox
 
 class MailBox {
   public: 
@@ -84,7 +90,8 @@ class MailBox {
     ~MailBox();			// De-allocate mail box
 
     void Put(PacketHeader pktHdr, MailHeader mailHdr, char *data);
-   				// Atomically put a message into the mailbox
+   				// Atomically put a message into the mailbox,
+				// or drop it if the mailbox is full
     void Get(PacketHeader *pktHdr, MailHeader *mailHdr, char *data); 
    				// Atomically get a message out of the 
 				// mailbox (and wait if there is no message 
@@ -113,8 +120,8 @@ class PostOfficeInput : public CallBackObj {
 				// there is no message in the box.
 
     static void PostalDelivery(void* data);
-				// Wait for incoming messages, 
-				// and then put them in the correct mailbox
+				// Put an incoming message in the
+				// correct mailbox
 
     void CallBack();		// Called when incoming packet has arrived 
 				// and can be pulled off of network 
@@ -124,7 +131,11 @@ class PostOfficeInput : public CallBackObj {
     NetworkInput *network;	// Physical network connection
     MailBox *boxes;		// Table of mail boxes to hold incoming mail
     int numBoxes;		// Number of mail boxes
-    Semaphore *messageAvailable;// V'ed when message has arrived from network
+    int numPending;		// messages arrived, not yet delivered;
+				// PostalDelivery is posted to the
+				// kernel's work queue only when this
+				// goes from 0 to 1, so messages are
+				// delivered in the order they arrive
 };
 
 class PostOfficeOutput : public CallBackObj {
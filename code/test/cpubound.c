@@ -0,0 +1,24 @@
+/* cpubound.c
+ *	A CPU-bound program for scheduler benchmarks: long stretches of
+ *	computation, and hardly any I/O.  Mix with iobound under -ep,
+ *	e.g. "nachos -ep cpubound 40 -ep iobound 120 -ep cpubound 90".
+ */
+
+#include "syscall.h"
+
+#define ROUNDS	5		/* CPU bursts */
+#define BURST	2000		/* iterations per burst */
+
+int
+main()
+{
+    int i, j, sum = 0;
+
+    for (i = 0; i < ROUNDS; i++) {
+	for (j = 0; j < BURST; j++) {
+	    sum += j;
+	}
+	PrintInt(i);
+    }
+    return 0;
+}
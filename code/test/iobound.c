@@ -0,0 +1,24 @@
+/* iobound.c
+ *	An I/O-bound program for scheduler benchmarks: short bursts of
+ *	computation, each followed by console output (which blocks the
+ *	thread until the console is done).  See cpubound.c.
+ */
+
+#include "syscall.h"
+
+#define ROUNDS	40		/* CPU bursts */
+#define BURST	50		/* iterations per burst */
+
+int
+main()
+{
+    int i, j, sum = 0;
+
+    for (i = 0; i < ROUNDS; i++) {
+	for (j = 0; j < BURST; j++) {
+	    sum += j;
+	}
+	PrintInt(sum);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+/* ulock.c
+ *	User-level locks and condition variables, built on futexes.
+ *
+ *	The lock is the three-state futex mutex of Drepper's "Futexes
+ *	Are Tricky": a thread that finds the lock held marks it 2 before
+ *	sleeping, so the releaser knows whether it has to make a system
+ *	call to wake anybody.
+ */
+
+#include "syscall.h"
+#include "ulock.h"
+
+#define ALL	0x7fffffff	/* wake every waiter */
+
+/* Atomically add "n" to *addr, and return the new value. */
+static int
+AtomicAdd(int *addr, int n)
+{
+    int old;
+
+    do {
+	old = *addr;
+    } while (!CompareAndSwap(addr, old, old + n));
+    return old + n;
+}
+
+void
+ULockInit(ULock *lock)
+{
+    lock->state = 0;
+}
+
+void
+ULockAcquire(ULock *lock)
+{
+    if (CompareAndSwap(&lock->state, 0, 1)) {
+	return;				/* it was free: no system call */
+    }
+    do {
+	if (lock->state == 2 || CompareAndSwap(&lock->state, 1, 2)) {
+	    FutexWait(&lock->state, 2);
+	}
+    } while (!CompareAndSwap(&lock->state, 0, 2));
+}
+
+void
+ULockRelease(ULock *lock)
+{
+    if (CompareAndSwap(&lock->state, 1, 0)) {
+	return;				/* nobody waiting: no system call */
+    }
+    lock->state = 0;
+    FutexWake(&lock->state, 1);
+}
+
+void
+UCondInit(UCond *cond)
+{
+    cond->seq = 0;
+    cond->waiters = 0;
+}
+
+void
+UCondWait(UCond *cond, ULock *lock)
+{
+    int seq = cond->seq;
+
+    AtomicAdd(&cond->waiters, 1);
+    ULockRelease(lock);
+    FutexWait(&cond->seq, seq);		/* returns at once if signalled */
+    AtomicAdd(&cond->waiters, -1);
+    ULockAcquire(lock);
+}
+
+void
+UCondSignal(UCond *cond)
+{
+    AtomicAdd(&cond->seq, 1);
+    if (cond->waiters > 0) {
+	FutexWake(&cond->seq, 1);
+    }
+}
+
+void
+UCondBroadcast(UCond *cond)
+{
+    AtomicAdd(&cond->seq, 1);
+    if (cond->waiters > 0) {
+	FutexWake(&cond->seq, ALL);
+    }
+}
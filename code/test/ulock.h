@@ -0,0 +1,38 @@
+/* ulock.h
+ *	User-level locks and condition variables, built on futexes (see
+ *	FutexWait and FutexWake in syscall.h).
+ *
+ *	Acquiring a free lock, releasing a lock nobody waits for, and
+ *	signalling a condition nobody waits on never trap into the
+ *	kernel; only waiting and waking up waiters do.
+ *
+ *	Link ulock.o into a program to use them.
+ */
+
+#ifndef ULOCK_H
+#define ULOCK_H
+
+/* A lock is 0 (free), 1 (held) or 2 (held, and maybe waited for). */
+typedef struct {
+    int state;
+} ULock;
+
+/* A condition counts its signals, so a waiter can tell whether one
+ * came between releasing the lock and going to sleep; "waiters" lets
+ * a signal with nobody waiting stay in user mode.
+ */
+typedef struct {
+    int seq;
+    int waiters;
+} UCond;
+
+void ULockInit(ULock *lock);
+void ULockAcquire(ULock *lock);
+void ULockRelease(ULock *lock);
+
+void UCondInit(UCond *cond);
+void UCondWait(UCond *cond, ULock *lock);	/* Mesa semantics */
+void UCondSignal(UCond *cond);
+void UCondBroadcast(UCond *cond);
+
+#endif /* ULOCK_H */
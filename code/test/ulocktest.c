@@ -0,0 +1,30 @@
+/* ulocktest.c
+ *	Exercise the user-level lock and condition variable.  Nobody
+ *	else uses them, so every operation takes the fast path, and the
+ *	"Futexes" line of the statistics should show no waits or wakes.
+ */
+
+#include "syscall.h"
+#include "ulock.h"
+
+#define ROUNDS	1000
+
+ULock lock;
+UCond cond;
+
+int
+main()
+{
+    int i, count = 0;
+
+    ULockInit(&lock);
+    UCondInit(&cond);
+    for (i = 0; i < ROUNDS; i++) {
+	ULockAcquire(&lock);
+	count++;
+	UCondSignal(&cond);
+	ULockRelease(&lock);
+    }
+    PrintInt(count);
+    return 0;
+}
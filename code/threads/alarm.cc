@@ -41,6 +41,8 @@ Alarm::Alarm(bool doRandom)
 //
 //	For now, just provide time-slicing.  Only need to time slice 
 //      if we're currently running something (in other words, not idle).
+//	The running thread's wake-up boost (-wakeboost) wears off here,
+//	once per tick it was running.
 //----------------------------------------------------------------------
 
 void 
@@ -50,6 +52,7 @@ Alarm::CallBack()
     MachineStatus status = interrupt->getStatus();
     // cout << "interrupt->YieldOnReturn()" << "\n";
     if (status != IdleMode) {
+	kernel->scheduler->DecayBoost(kernel->currentThread);
         // cout << "interrupt->YieldOnReturn()" << "\n";
 	    interrupt->YieldOnReturn();
     }
@@ -31,6 +31,8 @@ class Alarm : public CallBackObj {
     
     void WaitUntil(int x);	// suspend execution until time > now + x
                                 // this method is not yet implemented
+    void SetQuantum(int ticks) { timer->Rearm(ticks); }
+    				// time slice "ticks" long, from now on
 
   private:
     Timer *timer;		// the hardware timer device
@@ -0,0 +1,202 @@
+// burstpredict.cc
+//	Routines to predict CPU bursts, and to keep track of how far off
+//	the predictions are.  See burstpredict.h.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "burstpredict.h"
+#include "main.h"
+
+char *BurstPredictorNames = "ewma, window, median";
+
+//----------------------------------------------------------------------
+// NewBurstPredictor
+//	Create the burst predictor named "name".
+//
+// Returns:
+//	The new predictor, or NULL if "name" isn't a predictor we know.
+//----------------------------------------------------------------------
+
+BurstPredictor *
+NewBurstPredictor(char* name)
+{
+    if (strcmp(name, "ewma") == 0) {
+	return new EWMAPredictor();
+    } else if (strcmp(name, "window") == 0) {
+	return new WindowMeanPredictor();
+    } else if (strcmp(name, "median") == 0) {
+	return new MedianPredictor();
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// BurstHistory::BurstHistory
+//	Start the (empty) burst history of "thread".
+//----------------------------------------------------------------------
+
+BurstHistory::BurstHistory(Thread *thread)
+{
+    id = thread->getID();
+    name = thread->getName();
+    numRecent = 0;
+    predictions = 0;
+    absError = 0;
+    error = 0;
+}
+
+//----------------------------------------------------------------------
+// BurstHistory::Add
+//	Remember "burst", forgetting the oldest burst if we already have
+//	the last "window" of them.
+//----------------------------------------------------------------------
+
+void
+BurstHistory::Add(int burst, int window)
+{
+    if (numRecent == window) {
+	for (int i = 1; i < numRecent; i++) {
+	    recent[i - 1] = recent[i];
+	}
+	numRecent--;
+    }
+    recent[numRecent++] = burst;
+}
+
+//----------------------------------------------------------------------
+// BurstPredictor::BurstPredictor, BurstPredictor::~BurstPredictor
+//	Initialize and de-allocate the list of burst histories.
+//----------------------------------------------------------------------
+
+BurstPredictor::BurstPredictor()
+{
+    histories = new List<BurstHistory *>;
+}
+
+BurstPredictor::~BurstPredictor()
+{
+    while (!histories->IsEmpty()) {
+	delete histories->RemoveFront();
+    }
+    delete histories;
+}
+
+//----------------------------------------------------------------------
+// BurstPredictor::Update
+//	"thread" just ended a CPU burst of "burst" ticks.  Charge the
+//	prediction it had against the burst, and make a new one.
+//
+// Returns:
+//	The predicted length of the thread's next burst.
+//----------------------------------------------------------------------
+
+double
+BurstPredictor::Update(Thread* thread, int burst)
+{
+    BurstHistory *history = thread->bursts;
+    double miss = thread->apprBurstTime - burst;
+
+    if (history == NULL) {
+	history = thread->bursts = new BurstHistory(thread);
+	histories->Append(history);
+    }
+    history->predictions++;
+    history->error += miss;
+    history->absError += (miss < 0) ? -miss : miss;
+    history->Add(burst, kernel->schedParams->burstWindow);
+    return Predict(history, thread->apprBurstTime);
+}
+
+//----------------------------------------------------------------------
+// BurstPredictor::PrintStats
+//	Print the mean error of the predictions (and whether they ran
+//	long or short, on average), per thread and overall.
+//----------------------------------------------------------------------
+
+void
+BurstPredictor::PrintStats()
+{
+    ListIterator<BurstHistory *> iter(histories);
+    BurstHistory *h;
+    int predictions = 0;
+    double absError = 0, error = 0;
+
+    if (histories->IsEmpty()) {
+	return;
+    }
+    cout << "Burst prediction (" << getName() << ")\n";
+    cout << "Thread\tBursts\tError\tBias\tName\n";
+    for (; !iter.IsDone(); iter.Next()) {
+	h = iter.Item();
+	cout << h->id << "\t" << h->predictions << "\t"
+	     << h->absError / h->predictions << "\t"
+	     << h->error / h->predictions << "\t" << h->name << "\n";
+	predictions += h->predictions;
+	absError += h->absError;
+	error += h->error;
+    }
+    cout << "Burst prediction error: mean " << absError / predictions
+	 << " ticks, bias " << error / predictions << " (" << predictions
+	 << " bursts)\n";
+}
+
+//----------------------------------------------------------------------
+// EWMAPredictor::Predict
+//	Exponentially weighted moving average: the latest burst counts
+//	for alpha, everything before it for (1 - alpha).
+//----------------------------------------------------------------------
+
+double
+EWMAPredictor::Predict(BurstHistory* history, double last)
+{
+    double alpha = kernel->schedParams->burstAlpha;
+
+    return alpha * history->recent[history->numRecent - 1] +
+	   (1 - alpha) * last;
+}
+
+//----------------------------------------------------------------------
+// WindowMeanPredictor::Predict
+//	Mean of the last (up to) N bursts.
+//----------------------------------------------------------------------
+
+double
+WindowMeanPredictor::Predict(BurstHistory* history, double last)
+{
+    double sum = 0;
+
+    for (int i = 0; i < history->numRecent; i++) {
+	sum += history->recent[i];
+    }
+    return sum / history->numRecent;
+}
+
+//----------------------------------------------------------------------
+// MedianPredictor::Predict
+//	Median of the last (up to) N bursts: unlike the mean, one odd
+//	burst doesn't throw it off.
+//----------------------------------------------------------------------
+
+double
+MedianPredictor::Predict(BurstHistory* history, double last)
+{
+    int sorted[MaxBurstWindow];
+    int n = history->numRecent;
+    int i, j, v;
+
+    for (i = 0; i < n; i++) {		// insertion sort; n is small
+	v = history->recent[i];
+	for (j = i; j > 0 && sorted[j - 1] > v; j--) {
+	    sorted[j] = sorted[j - 1];
+	}
+	sorted[j] = v;
+    }
+    if (n % 2 == 1) {
+	return sorted[n / 2];
+    }
+    return (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+}
@@ -0,0 +1,103 @@
+// burstpredict.h
+//	Data structures to predict the length of a thread's next CPU
+//	burst, and to keep track of how good the predictions are.
+//
+//	The shortest-burst-first policies (sjf, and L1 of mlfq) order
+//	threads by Thread::apprBurstTime, the predicted length of their
+//	next burst.  Every time a thread blocks, the burst it just ended
+//	is handed to the predictor (selected with -predict), which
+//	returns the new prediction:
+//
+//		ewma	-- alpha * last burst + (1 - alpha) * last prediction
+//			   (-alpha, 0.5 by default)
+//		window	-- mean of the last N bursts (-window, 4 by default)
+//		median	-- median of the last N bursts
+//
+//	The predictor also compares each prediction with the burst that
+//	actually followed; the mean error, overall and per thread, is
+//	printed when Nachos halts.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef BURSTPREDICT_H
+#define BURSTPREDICT_H
+
+#include "copyright.h"
+#include "list.h"
+#include "thread.h"
+
+// Most bursts a predictor can look back on (-window)
+const int MaxBurstWindow = 32;
+
+// The following class holds the recent bursts of one thread, and how
+// far off the predictions for it were.  It outlives the thread, so
+// that the errors can still be reported at halt.
+
+class BurstHistory {
+  public:
+    BurstHistory(Thread *thread);
+
+    int id;			// the thread's ID
+    char *name;			// the thread's name
+    int recent[MaxBurstWindow];	// last bursts, oldest first
+    int numRecent;		// how many of them there are
+    int predictions;		// bursts predicted so far
+    double absError;		// sum of |prediction - burst|
+    double error;		// sum of prediction - burst (> 0 if
+				// predictions run long)
+
+    void Add(int burst, int window);	// remember the latest burst
+};
+
+// The following class is a burst predictor.  Subclasses decide the
+// prediction; this class keeps the histories and the errors.
+
+class BurstPredictor {
+  public:
+    BurstPredictor();
+    virtual ~BurstPredictor();
+
+    virtual char* getName() = 0;	// name, for printing
+    double Update(Thread* thread, int burst);
+    				// thread just ended a burst; return
+				// the prediction for its next one
+    void PrintStats();		// print the prediction errors, at halt
+
+  protected:
+    virtual double Predict(BurstHistory* history, double last) = 0;
+    				// predict from the history (latest
+				// burst last) and the last prediction
+
+  private:
+    List<BurstHistory *> *histories;	// every thread that ever blocked
+};
+
+class EWMAPredictor : public BurstPredictor {
+  public:
+    char* getName() { return "ewma"; }
+  protected:
+    double Predict(BurstHistory* history, double last);
+};
+
+class WindowMeanPredictor : public BurstPredictor {
+  public:
+    char* getName() { return "window"; }
+  protected:
+    double Predict(BurstHistory* history, double last);
+};
+
+class MedianPredictor : public BurstPredictor {
+  public:
+    char* getName() { return "median"; }
+  protected:
+    double Predict(BurstHistory* history, double last);
+};
+
+// Create the predictor named "name" (NULL if there is no such
+// predictor), and the names there are, for usage messages.
+extern BurstPredictor *NewBurstPredictor(char* name);
+extern char *BurstPredictorNames;
+
+#endif // BURSTPREDICT_H
@@ -0,0 +1,600 @@
+// fairshare.cc
+//	The proportional-share scheduling policies, and the accounting
+//	of how much CPU each thread got compared to its fair share.
+//
+//	These routines assume that interrupts are already disabled;
+//	they are only ever called from the Scheduler.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "fairshare.h"
+#include "main.h"
+
+// Weight of each band of 10 priority levels (0-9, 10-19, ..., 140-149):
+// 1024 * 1.25^(band - 5), so priority 50-59 has weight NiceZeroWeight.
+static int bandWeight[15] = {
+      335,   419,   524,   655,   819,
+     1024,  1280,  1600,  2000,  2500,
+     3125,  3906,  4883,  6104,  7629
+};
+
+//----------------------------------------------------------------------
+// PriorityToWeight
+//	Return the scheduling weight of a thread with the given priority.
+//----------------------------------------------------------------------
+
+int
+PriorityToWeight(int priority)
+{
+    if (priority < 0) {
+	priority = 0;
+    } else if (priority > 149) {
+	priority = 149;
+    }
+    return bandWeight[priority / 10];
+}
+
+//----------------------------------------------------------------------
+// ShareRecord::ShareRecord
+//	Start keeping track of "thread".  CPU time it used before now
+//	is not charged to it.
+//----------------------------------------------------------------------
+
+ShareRecord::ShareRecord(Thread *thread)
+{
+    id = thread->getID();
+    name = thread->getName();
+    weight = PriorityToWeight(thread->priority);
+    cpuTicks = thread->cpuTicks;
+    entitled = 0;
+    joinClock = 0;
+    runnable = FALSE;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::ShareAccounting
+//	Initialize the accounting; no threads, nothing charged yet.
+//----------------------------------------------------------------------
+
+ShareAccounting::ShareAccounting()
+{
+    records = new List<ShareRecord *>;
+    clock = 0;
+    runnableWeight = 0;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::~ShareAccounting
+//	De-allocate the share records.
+//----------------------------------------------------------------------
+
+ShareAccounting::~ShareAccounting()
+{
+    while (!records->IsEmpty()) {
+	delete records->RemoveFront();
+    }
+    delete records;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::Record
+//	Return the share record of "thread", creating it the first time
+//	we see the thread.
+//----------------------------------------------------------------------
+
+ShareRecord *
+ShareAccounting::Record(Thread *thread)
+{
+    if (thread->share == NULL) {
+	thread->share = new ShareRecord(thread);
+	records->Append(thread->share);
+    }
+    return thread->share;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::Join
+//	"thread" has become runnable: from now on, it is entitled to its
+//	weight's fraction of the CPU.
+//----------------------------------------------------------------------
+
+void
+ShareAccounting::Join(Thread *thread)
+{
+    ShareRecord *rec = Record(thread);
+
+    if (!rec->runnable) {
+	rec->joinClock = clock;
+	rec->runnable = TRUE;
+	runnableWeight += rec->weight;
+    }
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::Leave
+//	"thread" is no longer runnable; credit it with what it was
+//	entitled to while it was.
+//----------------------------------------------------------------------
+
+void
+ShareAccounting::Leave(Thread *thread)
+{
+    ShareRecord *rec = Record(thread);
+
+    if (rec->runnable) {
+	rec->entitled += rec->weight * (clock - rec->joinClock);
+	rec->runnable = FALSE;
+	runnableWeight -= rec->weight;
+    }
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::Charge
+//	Bill "thread" for the CPU ticks it used since it was last
+//	charged, and advance the share clock accordingly.
+//
+// Returns:
+//	The number of ticks billed.
+//----------------------------------------------------------------------
+
+int
+ShareAccounting::Charge(Thread *thread)
+{
+    ShareRecord *rec = Record(thread);
+    int ticks = thread->cpuTicks - rec->cpuTicks;
+
+    rec->cpuTicks = thread->cpuTicks;
+    if (runnableWeight > 0) {
+	clock += (double) ticks / runnableWeight;
+    }
+    return ticks;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::SetWeight
+//	The weight of "thread" changed.  What it was entitled to so far
+//	is settled at the old weight.
+//----------------------------------------------------------------------
+
+void
+ShareAccounting::SetWeight(Thread *thread, int weight)
+{
+    ShareRecord *rec = Record(thread);
+
+    if (rec->weight == weight) {
+	return;
+    }
+    if (rec->runnable) {
+	rec->entitled += rec->weight * (clock - rec->joinClock);
+	rec->joinClock = clock;
+	runnableWeight += weight - rec->weight;
+    }
+    rec->weight = weight;
+}
+
+//----------------------------------------------------------------------
+// ShareAccounting::Print
+//	Print, for every thread, the share of the CPU it got and the
+//	share it was entitled to (its "target").  Called at halt.
+//----------------------------------------------------------------------
+
+void
+ShareAccounting::Print(char *policyName)
+{
+    ListIterator<ShareRecord *> settle(records);
+    ListIterator<ShareRecord *> report(records);
+    ShareRecord *rec;
+    int total = 0;
+
+    for (; !settle.IsDone(); settle.Next()) {
+	rec = settle.Item();
+	if (rec->runnable) {		// settle threads still runnable
+	    rec->entitled += rec->weight * (clock - rec->joinClock);
+	    rec->joinClock = clock;
+	}
+	total += rec->cpuTicks;
+    }
+
+    cout << "Fair share (" << policyName << "), " << total
+	 << " ticks charged:\n";
+    if (total == 0) {
+	return;
+    }
+    cout << "Thread\tWeight\tTicks\tShare%\tTarget%\tName\n";
+    for (; !report.IsDone(); report.Next()) {
+	rec = report.Item();
+	cout << rec->id << "\t" << rec->weight << "\t" << rec->cpuTicks
+	     << "\t" << (int) (1000.0 * rec->cpuTicks / total + 0.5) / 10.0
+	     << "\t" << (int) (1000.0 * rec->entitled / total + 0.5) / 10.0
+	     << "\t" << rec->name << "\n";
+    }
+}
+
+//----------------------------------------------------------------------
+// VruntimeCompare
+//	Ordering for the CFS ready heap: least virtual runtime first.
+//----------------------------------------------------------------------
+
+static int
+VruntimeCompare(Thread* a, Thread* b)
+{
+    if (a->vruntime > b->vruntime) return 1;
+    if (a->vruntime < b->vruntime) return -1;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::CFSPolicy
+//	Initialize an empty virtual runtime ordered ready heap.
+//----------------------------------------------------------------------
+
+CFSPolicy::CFSPolicy()
+{
+    readyList = new Heap<Thread *>(VruntimeCompare, ReadyIndex);
+    accounting = new ShareAccounting();
+    minVruntime = 0;
+    sliceStart = 0;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::~CFSPolicy
+//	De-allocate the ready heap and the accounting.
+//----------------------------------------------------------------------
+
+CFSPolicy::~CFSPolicy()
+{
+    delete readyList;
+    delete accounting;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Charge
+//	Bill "thread" for the CPU it used since it was last charged:
+//	its virtual runtime advances by the ticks used, scaled by
+//	NiceZeroWeight / its weight -- so heavier threads age slower,
+//	and get to run longer.  Then pick up any change in its priority.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Charge(Thread* thread)
+{
+    ShareRecord *rec = accounting->Record(thread);
+    int ticks;
+
+    accounting->Join(thread);		// e.g., main, which was never
+					// put on the ready list
+    ticks = accounting->Charge(thread);
+    thread->vruntime += (double) ticks * NiceZeroWeight / rec->weight;
+    accounting->SetWeight(thread, PriorityToWeight(thread->priority));
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::UpdateMinVruntime
+//	Move minVruntime up to the least virtual runtime of any
+//	runnable thread -- the running thread or the head of the ready
+//	heap.  It never moves back.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::UpdateMinVruntime(Thread* current)
+{
+    double least = current->vruntime;
+
+    if (!readyList->IsEmpty() && readyList->Front()->vruntime < least) {
+	least = readyList->Front()->vruntime;
+    }
+    if (least > minVruntime) {
+	minVruntime = least;
+    }
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::ReadyToRun
+//	Put a thread on the ready heap.
+//
+//	A thread that was not runnable (new, or just woken up) would
+//	otherwise come back with the virtual runtime it had when it
+//	left, and could hog the CPU until it caught up.  Instead, it
+//	starts no more than one granularity behind everyone else.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::ReadyToRun(Thread* thread)
+{
+    ShareRecord *rec = accounting->Record(thread);
+
+    if (!rec->runnable) {
+	if (thread->vruntime < minVruntime - CFSMinGranularity) {
+	    thread->vruntime = minVruntime - CFSMinGranularity;
+	}
+	accounting->SetWeight(thread, PriorityToWeight(thread->priority));
+	accounting->Join(thread);
+    }
+    readyList->Insert(thread);
+    DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks
+	  << "]: Thread [" << thread->getID()
+	  << "] is inserted with vruntime [" << thread->vruntime << "]");
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::PickNext
+//	Dequeue the ready thread with the least virtual runtime.
+//----------------------------------------------------------------------
+
+Thread *
+CFSPolicy::PickNext()
+{
+    Thread *nextToRun;
+
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    nextToRun = readyList->RemoveFront();
+    UpdateMinVruntime(nextToRun);
+    sliceStart = nextToRun->cpuTicks;
+    DEBUG(dbgMFQ, "[B] Tick [" << kernel->stats->totalTicks
+	  << "]: Thread [" << nextToRun->getID()
+	  << "] is removed with vruntime [" << nextToRun->vruntime << "]");
+    return nextToRun;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::OnTick
+//	Charge the running thread, then preempt it if it has had its
+//	minimum granularity and some ready thread has had less (virtual)
+//	CPU than it.
+//----------------------------------------------------------------------
+
+bool
+CFSPolicy::OnTick(Thread* current)
+{
+    Charge(current);
+    UpdateMinVruntime(current);
+    return !readyList->IsEmpty() &&
+	current->cpuTicks - sliceStart >= CFSMinGranularity &&
+	readyList->Front()->vruntime < current->vruntime;
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::OnBlock, CFSPolicy::OnFinish
+//	The running thread stops being runnable; charge it for the
+//	last of its CPU time first.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::OnBlock(Thread* thread)
+{
+    Charge(thread);
+    accounting->Leave(thread);
+}
+
+void
+CFSPolicy::OnFinish(Thread* thread)
+{
+    Charge(thread);
+    accounting->Leave(thread);
+    thread->share = NULL;	// the record outlives the thread
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Reorder
+//	A ready thread's priority may have changed.  That changes its
+//	weight -- how fast its virtual runtime advances from now on --
+//	but not its place on the ready heap.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Reorder(Thread* thread)
+{
+    accounting->SetWeight(thread, PriorityToWeight(thread->priority));
+}
+
+//----------------------------------------------------------------------
+// CFSPolicy::Print
+//	Print the contents of the ready heap.  For debugging.
+//----------------------------------------------------------------------
+
+void
+CFSPolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
+
+//----------------------------------------------------------------------
+// PassCompare
+//	Ordering for the stride ready heap: smallest pass first.
+//----------------------------------------------------------------------
+
+static int
+PassCompare(Thread* a, Thread* b)
+{
+    if (a->pass > b->pass) return 1;
+    if (a->pass < b->pass) return -1;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::StridePolicy
+//	Initialize an empty pass ordered ready heap.
+//----------------------------------------------------------------------
+
+StridePolicy::StridePolicy()
+{
+    readyList = new Heap<Thread *>(PassCompare, ReadyIndex);
+    accounting = new ShareAccounting();
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::~StridePolicy
+//	De-allocate the ready heap and the accounting.
+//----------------------------------------------------------------------
+
+StridePolicy::~StridePolicy()
+{
+    delete readyList;
+    delete accounting;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Retune
+//	If the tickets of "thread" changed, scale what is left of its
+//	current stride -- how far its pass is from the global pass --
+//	to the new number of tickets.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Retune(Thread* thread)
+{
+    ShareRecord *rec = accounting->Record(thread);
+    double global = accounting->Clock();
+
+    if (rec->weight == thread->tickets) {
+	return;
+    }
+    if (rec->runnable) {
+	thread->pass = global +
+	    (thread->pass - global) * rec->weight / thread->tickets;
+    } else {			// pass is relative while not runnable
+	thread->pass = thread->pass * rec->weight / thread->tickets;
+    }
+    accounting->SetWeight(thread, thread->tickets);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Charge
+//	Bill "thread" for the CPU it used since it was last charged:
+//	its pass advances by ticks / tickets.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Charge(Thread* thread)
+{
+    ShareRecord *rec = accounting->Record(thread);
+    int ticks;
+
+    if (!rec->runnable) {		// e.g., main, which was never
+	accounting->SetWeight(thread, thread->tickets);
+	accounting->Join(thread);	// put on the ready list
+	thread->pass += accounting->Clock();
+    }
+    ticks = accounting->Charge(thread);
+    thread->pass += (double) ticks / rec->weight;
+    Retune(thread);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Leave
+//	"thread" blocked or finished; from now on, keep its pass
+//	relative to the global pass.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Leave(Thread* thread)
+{
+    Charge(thread);
+    thread->pass -= accounting->Clock();
+    accounting->Leave(thread);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::ReadyToRun
+//	Put a thread on the ready heap.  A thread that was not runnable
+//	(new, or just woken up) rejoins at the global pass, plus
+//	whatever it had left when it blocked.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::ReadyToRun(Thread* thread)
+{
+    ShareRecord *rec = accounting->Record(thread);
+
+    if (!rec->runnable) {
+	Retune(thread);
+	accounting->Join(thread);
+	thread->pass += accounting->Clock();
+    }
+    readyList->Insert(thread);
+    DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks
+	  << "]: Thread [" << thread->getID()
+	  << "] is inserted with pass [" << thread->pass << "]");
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::PickNext
+//	Dequeue the ready thread with the smallest pass.
+//----------------------------------------------------------------------
+
+Thread *
+StridePolicy::PickNext()
+{
+    Thread *nextToRun;
+
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    nextToRun = readyList->RemoveFront();
+    DEBUG(dbgMFQ, "[B] Tick [" << kernel->stats->totalTicks
+	  << "]: Thread [" << nextToRun->getID()
+	  << "] is removed with pass [" << nextToRun->pass << "]");
+    return nextToRun;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::OnTick
+//	Charge the running thread, then preempt it if some ready thread
+//	has a smaller pass.
+//----------------------------------------------------------------------
+
+bool
+StridePolicy::OnTick(Thread* current)
+{
+    Charge(current);
+    return !readyList->IsEmpty() &&
+	readyList->Front()->pass < current->pass;
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::OnBlock, StridePolicy::OnFinish
+//	The running thread stops being runnable.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::OnBlock(Thread* thread)
+{
+    Leave(thread);
+}
+
+void
+StridePolicy::OnFinish(Thread* thread)
+{
+    Leave(thread);
+    thread->share = NULL;	// the record outlives the thread
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Reorder
+//	A ready thread's tickets may have changed; that moves its pass,
+//	and so its place on the ready heap.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Reorder(Thread* thread)
+{
+    Retune(thread);
+    readyList->Update(thread);
+}
+
+//----------------------------------------------------------------------
+// StridePolicy::Print
+//	Print the contents of the ready heap.  For debugging.
+//----------------------------------------------------------------------
+
+void
+StridePolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
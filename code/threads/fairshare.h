@@ -0,0 +1,160 @@
+// fairshare.h
+//	Data structures for the proportional-share scheduling policies.
+//
+//	Rather than strict priority bands, these policies give each
+//	runnable thread a share of the CPU in proportion to its weight
+//	(derived from its priority).
+//
+//	Two policies are provided: "cfs", which derives the weights
+//	from priorities, and "stride", where they are tickets.
+//
+//	ShareAccounting keeps track, per thread, of the CPU time it got
+//	and the CPU time it was entitled to -- its weight's fraction of
+//	the total weight runnable at the time -- so that we can report
+//	how fair the policy actually was when Nachos halts.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef FAIRSHARE_H
+#define FAIRSHARE_H
+
+#include "copyright.h"
+#include "list.h"
+#include "heap.h"
+#include "stats.h"
+#include "thread.h"
+#include "schedpolicy.h"
+
+// The weight of a thread of priority 50-59; every 10 points of
+// priority above (or below) that is worth 25% more (or less) CPU.
+const int NiceZeroWeight = 1024;
+
+extern int PriorityToWeight(int priority);
+
+// The following class records what one thread got, and should
+// have got, from the CPU.  It outlives the thread, so that the
+// numbers for finished threads can still be reported at halt.
+
+class ShareRecord {
+  public:
+    ShareRecord(Thread *thread);
+
+    int id;			// the thread's ID
+    char *name;			// the thread's name
+    int weight;			// current weight (or tickets)
+    int cpuTicks;		// CPU ticks charged so far
+    double entitled;		// CPU ticks it was entitled to
+    double joinClock;		// share clock when it last became
+				// runnable
+    bool runnable;		// ready or running?
+};
+
+// The following class keeps the share records for all threads.
+//
+// Entitlement is computed with a "share clock" that advances by
+// ticks / (total runnable weight) each time CPU time is charged,
+// so a thread of weight w that stays runnable while the clock moves
+// by dV is entitled to w * dV ticks -- no need to visit every
+// runnable thread on every charge.
+
+class ShareAccounting {
+  public:
+    ShareAccounting();
+    ~ShareAccounting();
+
+    ShareRecord *Record(Thread *thread);
+    				// thread's record, created if need be
+    void Join(Thread *thread);	// thread became runnable
+    void Leave(Thread *thread);	// thread blocked or finished
+    int Charge(Thread *thread);	// bill thread for the CPU time it
+				// used since its last charge, and
+				// return the number of ticks billed
+    void SetWeight(Thread *thread, int weight);
+    				// thread's weight changed
+    void Print(char *policyName);
+    				// report achieved vs target shares
+    double Clock() { return clock; }
+    				// CPU ticks each unit of weight was
+				// entitled to so far
+
+  private:
+    List<ShareRecord *> *records;	// every thread ever seen
+    double clock;		// share clock (see above)
+    int runnableWeight;		// total weight of runnable threads
+};
+
+// Completely fair scheduling: every thread accumulates "virtual
+// runtime" -- CPU ticks scaled down by its weight -- and the thread
+// with the least virtual runtime runs next.  The running thread is
+// preempted, once it has had at least CFSMinGranularity ticks, as soon
+// as some ready thread has less virtual runtime than it.
+
+// A thread runs at least this long before it can be preempted
+const int CFSMinGranularity = TimerTicks;
+
+class CFSPolicy : public SchedPolicy {
+  public:
+    CFSPolicy();
+    ~CFSPolicy();
+
+    char* getName() { return "cfs"; }
+    void ReadyToRun(Thread* thread);
+    Thread* PickNext();
+    bool OnTick(Thread* current);
+    void OnBlock(Thread* thread);
+    void OnFinish(Thread* thread);
+    void Reorder(Thread* thread);
+    void Print();
+    void PrintStats() { accounting->Print(getName()); }
+
+  private:
+    Heap<Thread *> *readyList;	// least virtual runtime first
+    ShareAccounting *accounting;// who got how much CPU
+    double minVruntime;		// monotonic lower bound on the
+				// virtual runtime of runnable threads
+    int sliceStart;		// running thread's cpuTicks when it
+				// was picked
+
+    void Charge(Thread* thread);// advance thread's virtual runtime
+    void UpdateMinVruntime(Thread* current);
+    				// move minVruntime up, if we can
+};
+
+// Stride scheduling: every thread holds "tickets" (seeded from its
+// priority, changed with the SetTickets system call), and gets CPU
+// time in proportion to them.  Each thread has a "pass" that advances
+// by ticks / tickets as it runs; on every timer tick, the running
+// thread gives way to the ready thread with the smallest pass.
+//
+// The pass is kept relative to the share clock, the "global pass":
+// a thread that blocks keeps only the difference, and picks up from
+// there when it wakes, so sleeping neither earns nor loses it CPU.
+
+class StridePolicy : public SchedPolicy {
+  public:
+    StridePolicy();
+    ~StridePolicy();
+
+    char* getName() { return "stride"; }
+    void ReadyToRun(Thread* thread);
+    Thread* PickNext();
+    bool OnTick(Thread* current);
+    void OnBlock(Thread* thread);
+    void OnFinish(Thread* thread);
+    void Reorder(Thread* thread);
+    void Print();
+    void PrintStats() { accounting->Print(getName()); }
+
+  private:
+    Heap<Thread *> *readyList;	// smallest pass first
+    ShareAccounting *accounting;// who got how much CPU; its clock
+				// is the global pass
+
+    void Charge(Thread* thread);// advance thread's pass
+    void Retune(Thread* thread);// pick up a change of tickets
+    void Leave(Thread* thread);	// thread is no longer runnable
+};
+
+#endif // FAIRSHARE_H
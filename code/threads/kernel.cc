@@ -13,6 +13,10 @@
 #include "synch.h"
 #include "synchlist.h"
 #include "libtest.h"
+#include "microbench.h"
+#include "workqueue.h"
+#include "futex.h"
+#include "lockprof.h"
 #include "string.h"
 #include "synchdisk.h"
 #include "post.h"
@@ -26,7 +30,14 @@
 
 Kernel::Kernel(int argc, char **argv)
 {
+    ProcessGroup *group = NULL;	// group of the programs that follow
+    schedParams = new SchedParams();	// defaults, changed by the flags below
     randomSlice = FALSE; 
+    schedPolicy = "mlfq";	// default is the multilevel feedback queue
+    burstPredictor = "ewma";	// default is an exponential average
+    recordFile = NULL;		// default is not to record a trace
+    stackPoolSize = 16;		// free stacks to keep, of each size
+    lockProfiler = NULL;	// no lock profiling
     debugUserProg = FALSE;
     consoleIn = NULL;          // default is stdin
     consoleOut = NULL;         // default is stdout
@@ -36,6 +47,9 @@ Kernel::Kernel(int argc, char **argv)
     reliability = 1;            // network reliability, default is 1.0
     hostName = 0;               // machine id, also UNIX socket name
                                 // 0 is the default machine id
+    numGroups = 0;
+    execFiles = new List<ExecFile *>;
+    processTable = new ProcessTable();
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-rs") == 0) {
  	    	ASSERT(i + 1 < argc);
@@ -45,8 +59,59 @@ Kernel::Kernel(int argc, char **argv)
 	    	i++;
         } else if (strcmp(argv[i], "-s") == 0) {
             debugUserProg = TRUE;
+        } else if (strcmp(argv[i], "-sched") == 0) {
+            ASSERT(i + 1 < argc);
+            schedPolicy = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "-record") == 0) {
+            ASSERT(i + 1 < argc);
+            recordFile = argv[i + 1];
+            i++;
+        } else if (strcmp(argv[i], "-quantum") == 0) {
+            ASSERT(i + 3 < argc);   // time slice on L1, L2 and L3
+            for (int level = 0; level < 3; level++) {
+                schedParams->quantum[level] = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "-aging") == 0) {
+            ASSERT(i + 2 < argc);   // waiting ticks, priority step
+            schedParams->agingInterval = atoi(argv[++i]);
+            schedParams->agingStep = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-bands") == 0) {
+            ASSERT(i + 2 < argc);   // lowest priority on L2, then on L1
+            schedParams->l2Lowest = atoi(argv[++i]);
+            schedParams->l1Lowest = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-alpha") == 0) {
+            ASSERT(i + 1 < argc);   // next argument is float
+            schedParams->burstAlpha = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-predict") == 0) {
+            ASSERT(i + 1 < argc);
+            burstPredictor = argv[++i];
+        } else if (strcmp(argv[i], "-group") == 0) {
+            ASSERT(i + 3 < argc);   // name, share, quota
+            ASSERT(numGroups < MaxGroups);
+            group = new ProcessGroup(numGroups + 1, argv[i + 1],
+                                     atoi(argv[i + 2]), atoi(argv[i + 3]));
+            groups[numGroups++] = group;
+            i += 3;
+        } else if (strcmp(argv[i], "-wakeboost") == 0) {
+            ASSERT(i + 2 < argc);   // boost, decay per tick
+            schedParams->wakeBoost = atoi(argv[++i]);
+            schedParams->wakeDecay = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-stackpool") == 0) {
+            ASSERT(i + 1 < argc);   // 0 turns recycling off
+            stackPoolSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-lockprof") == 0) {
+            ASSERT(i + 1 < argc);   // how many locks to print
+            lockProfiler = new LockProfiler(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-gwindow") == 0) {
+            ASSERT(i + 1 < argc);   // ticks per accounting window
+            schedParams->groupWindow = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-window") == 0) {
+            ASSERT(i + 1 < argc);   // bursts to look back on
+            schedParams->burstWindow = atoi(argv[++i]);
 		} else if (strcmp(argv[i], "-e") == 0) {
-        	execfile[++execfileNum]= argv[++i];
+        	ASSERT(i + 1 < argc);
+        	execFiles->Append(new ExecFile(argv[++i], 0, group));
 		} else if (strcmp(argv[i], "-ci") == 0) {
 	    	ASSERT(i + 1 < argc);
 	    	consoleIn = argv[i + 1];
@@ -70,20 +135,32 @@ Kernel::Kernel(int argc, char **argv)
         } else if (strcmp(argv[i], "-u") == 0) {
             cout << "Partial usage: nachos [-rs randomSeed]\n";
 	   		cout << "Partial usage: nachos [-s]\n";
+            cout << "Partial usage: nachos [-sched " << SchedPolicyNames << "]\n";
+            cout << "Partial usage: nachos [-record traceFile]\n";
+            cout << "Partial usage: nachos [-quantum L1 L2 L3] [-aging ticks step]\n";
+            cout << "Partial usage: nachos [-bands L2lowest L1lowest] [-alpha a]\n";
+            cout << "Partial usage: nachos [-predict " << BurstPredictorNames
+                 << "] [-window n]\n";
+            cout << "Partial usage: nachos [-group name share quota] "
+                 << "[-gwindow ticks]\n";
+            cout << "Partial usage: nachos [-wakeboost boost decay]\n";
+            cout << "Partial usage: nachos [-stackpool n]\n";
+            cout << "Partial usage: nachos [-lockprof locks]\n";
             cout << "Partial usage: nachos [-ci consoleIn] [-co consoleOut]\n";
 #ifndef FILESYS_STUB
 	    	cout << "Partial usage: nachos [-nf]\n";
 #endif
             cout << "Partial usage: nachos [-n #] [-m #]\n";
 		} else if(strcmp(argv[i], "-ep") == 0){
-            execfile[++execfileNum]= argv[++i];
+            ASSERT(i + 2 < argc);
+            char *name = argv[++i];
             short p = 0;
             ++i;
             for(int j = 0 ; j < strlen(argv[i]) ; j++){
                 p = p*10+(argv[i][j] - '0');
             }
-            execPriority[execfileNum] = p;
-			//cout << "Executing: "<<execfile[execfileNum] <<", priority: "<<execPriority[execfileNum]<< "\n";
+            execFiles->Append(new ExecFile(name, p, group));
+			//cout << "Executing: "<<name <<", priority: "<<p<< "\n";
         }
     }
 }
@@ -106,14 +183,42 @@ Kernel::Initialize()
     numFreeFrame = NumPhysPages;
 
 
-    currentThread = new Thread("main", threadNum++);		
+    int pid = processTable->Allocate();		// PID 0
+    currentThread = new Thread("main", pid);		
+    processTable->Set(pid, currentThread);
     currentThread->setStatus(RUNNING);
 
     stats = new Statistics();		// collect statistics
+    stackPool = new StackPool(stackPoolSize);	// thread stacks
     interrupt = new Interrupt;		// start up interrupt handling
-    scheduler = new Scheduler();	// initialize the ready queue
+    if (!schedParams->Check()) {
+        cerr << "Bad scheduling parameters: quanta must be positive, "
+             << "0 < L2lowest < L1lowest <= " << schedParams->maxPriority
+             << ", 0 <= alpha <= 1, 1 <= window <= " << MaxBurstWindow
+             << "\n";
+        Exit(1);
+    }
+    SchedPolicy *policy = NewSchedPolicy(schedPolicy);
+    if (policy == NULL) {
+        cerr << "Unknown scheduling policy: " << schedPolicy << "\n";
+        cerr << "Choose one of: " << SchedPolicyNames << "\n";
+        Exit(1);
+    }
+    scheduler = new Scheduler(policy);	// initialize the ready queue
+    workQueue = new WorkQueue("kernel work", KernelWorkers);
+    BurstPredictor *predictor = NewBurstPredictor(burstPredictor);
+    if (predictor == NULL) {
+        cerr << "Unknown burst predictor: " << burstPredictor << "\n";
+        cerr << "Choose one of: " << BurstPredictorNames << "\n";
+        Exit(1);
+    }
+    scheduler->SetPredictor(predictor);
+    if (recordFile != NULL) {
+        scheduler->RecordTrace(new TraceRecorder(recordFile));
+    }
     alarm = new Alarm(randomSlice);	// start up time slicing
     machine = new Machine(debugUserProg);
+    futexTable = new FutexTable();
     synchConsoleIn = new SynchConsoleInput(consoleIn); // input from stdin
     synchConsoleOut = new SynchConsoleOutput(consoleOut); // output to stdout
     synchDisk = new SynchDisk();    //
@@ -137,8 +242,21 @@ Kernel::~Kernel()
 {
     delete stats;
     delete interrupt;
+    delete workQueue;
     delete scheduler;
+    delete stackPool;
+    delete schedParams;
+    for (int i = 0; i < numGroups; i++) {
+        delete groups[i];
+    }
+    while (!execFiles->IsEmpty()) {
+        delete execFiles->RemoveFront();
+    }
+    delete execFiles;
+    delete processTable;
     delete alarm;
+    delete futexTable;
+    delete lockProfiler;
     delete machine;
     delete synchConsoleIn;
     delete synchConsoleOut;
@@ -152,13 +270,15 @@ Kernel::~Kernel()
 
 //----------------------------------------------------------------------
 // Kernel::ThreadSelfTest
-//      Test threads, semaphores, synchlists
+//      Test threads, semaphores, synchlists, reader-writer locks, and
+//	stackless tasks
 //----------------------------------------------------------------------
 
 void
 Kernel::ThreadSelfTest() {
    Semaphore *semaphore;
    SynchList<int> *synchList;
+   RWLock *rwLock;
    
    LibSelfTest();		// test library routines
    
@@ -175,6 +295,35 @@ Kernel::ThreadSelfTest() {
    synchList->SelfTest(9);
    delete synchList;
 
+   				// test reader-writer locks
+   rwLock = new RWLock("test");
+   rwLock->SelfTest();
+   rwLock->PrintStats();
+   delete rwLock;
+   rwLock = new RWLock("fair test", TRUE);
+   rwLock->SelfTest();
+   rwLock->PrintStats();
+   delete rwLock;
+
+   				// test stackless tasks, with disk
+				// requests outstanding on a handful
+				// of sectors
+   synchDisk->SelfTest(8);
+
+}
+
+//----------------------------------------------------------------------
+// Kernel::MicroBenchmark
+//      Time threads, semaphores, locks, conditions and synchlists,
+//	repeating each operation "iterations" times (see microbench.h)
+//----------------------------------------------------------------------
+
+void
+Kernel::MicroBenchmark(int iterations) {
+    MicroBench *bench = new MicroBench(iterations);
+
+    bench->Run();
+    delete bench;
 }
 
 //----------------------------------------------------------------------
@@ -271,23 +420,29 @@ void ForkExecute(Thread *t)
 
 void Kernel::ExecAll()
 {
-	for (int i=1;i<=execfileNum;i++) {
-		int a = Exec(execfile[i]);
+	ListIterator<ExecFile *> iter(execFiles);
+
+	for (; !iter.IsDone(); iter.Next()) {
+		ExecFile *e = iter.Item();
+		int a = Exec(e->name, e->priority, e->group);
 	}
 	currentThread->Finish();
     //Kernel::Exec();	
 }
 
 
-int Kernel::Exec(char* name)
+int Kernel::Exec(char* name, int priority, ProcessGroup *group)
 {
-    //cout << name << ' ' << threadNum<< '\n';
-	t[threadNum] = new Thread(name, threadNum);
-	t[threadNum]->space = new AddrSpace();
-	t[threadNum]->Fork((VoidFunctionPtr) &ForkExecute, (void *)t[threadNum]);
-	threadNum++;
+	int pid = processTable->Allocate();	// a free slot, or a new one
+	Thread *t = new Thread(name, pid);
+
+	processTable->Set(pid, t);
+	t->setPriority(priority);
+	t->group = group;			// NULL if none
+	t->space = new AddrSpace();
+	t->Fork((VoidFunctionPtr) &ForkExecute, (void *)t);
 
-	return threadNum-1;
+	return pid;
 /*
     cout << "Total threads number is " << execfileNum << endl;
     for (int n=1;n<=execfileNum;n++) {
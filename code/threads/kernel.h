@@ -18,12 +18,17 @@
 #include "alarm.h"
 #include "filesys.h"
 #include "machine.h"
+#include "stackpool.h"
+#include "proctable.h"
 
 class PostOfficeInput;
 class PostOfficeOutput;
 class SynchConsoleInput;
 class SynchConsoleOutput;
 class SynchDisk;
+class WorkQueue;
+class FutexTable;
+class LockProfiler;
 
 typedef int OpenFileId;
 
@@ -37,12 +42,15 @@ class Kernel {
 				// from constructor because 
 				// refers to "kernel" as a global
     void ExecAll();
-    int Exec(char* name);
+    int Exec(char* name, int priority, ProcessGroup *group);
+    				// run a program; returns its PID
     void ThreadSelfTest();	// self test of threads and synchronization
+    void MicroBenchmark(int iterations);
+    				// time threads and synchronization
 	
     void ConsoleTest();         // interactive console self test
     void NetworkTest();         // interactive 2-machine network test
-    Thread* getThread(int threadID){return t[threadID];}    
+    Thread* getThread(int threadID){return processTable->Lookup(threadID);}
 
 
     void PrintInt(int number); 	
@@ -61,6 +69,13 @@ class Kernel {
     Interrupt *interrupt;	// interrupt status
     Statistics *stats;		// performance metrics
     Alarm *alarm;		// the software alarm clock    
+    SchedParams *schedParams;	// tunable scheduling parameters
+    StackPool *stackPool;	// recycled thread stacks
+    ProcessTable *processTable;	// PID of every program's thread
+    WorkQueue *workQueue;	// work deferred by interrupt handlers
+    FutexTable *futexTable;	// user threads waiting on futexes
+    LockProfiler *lockProfiler;	// lock contention, NULL unless
+				// -lockprof
     Machine *machine;           // the simulated CPU
     SynchConsoleInput *synchConsoleIn;
     SynchConsoleOutput *synchConsoleOut;
@@ -74,15 +89,17 @@ class Kernel {
     int numFreeFrame;
 
     int hostName;               // machine identifier
-    short execPriority[10];
   private:
+    ProcessGroup *groups[MaxGroups];	// process groups (-group)
+    int numGroups;
 
-	Thread* t[10];
-	char*   execfile[10];
-  
-	int execfileNum;
-	int threadNum;
+    List<ExecFile *> *execFiles;	// programs to run (-e, -ep)
     bool randomSlice;		// enable pseudo-random time slicing
+    char *schedPolicy;		// name of the scheduling policy (-sched)
+    char *burstPredictor;	// name of the burst predictor (-predict)
+    int stackPoolSize;		// free stacks kept per size (-stackpool)
+    char *recordFile;		// where to record a scheduling trace
+				// (-record), NULL if not recording
     bool debugUserProg;         // single step user program
     double reliability;         // likelihood messages are dropped
     char *consoleIn;            // file to read console input from
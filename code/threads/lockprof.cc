@@ -0,0 +1,200 @@
+// lockprof.cc
+//	Routines to profile contention on locks and semaphores.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "lockprof.h"
+#include <string.h>
+
+//----------------------------------------------------------------------
+// LockProfile::LockProfile
+//	A profile of the locks (or semaphores) named "debugName", which
+//	have not been used yet.
+//----------------------------------------------------------------------
+
+LockProfile::LockProfile(char *debugName, bool isLock)
+{
+    name = debugName;
+    lock = isLock;
+    acquires = contended = 0;
+    totalWait = maxWait = 0;
+    peakHolder = NULL;
+    totalHold = maxHold = 0;
+}
+
+//----------------------------------------------------------------------
+// LockProfile::Acquired
+//	Record an acquisition.  If the caller "waited", it did so for
+//	"waitTicks", for the thread named "holderName" (NULL if there is
+//	no such thing, as for a semaphore).
+//----------------------------------------------------------------------
+
+void
+LockProfile::Acquired(bool waited, int waitTicks, char *holderName)
+{
+    acquires++;
+    if (!waited) {
+	return;
+    }
+    contended++;
+    totalWait += waitTicks;
+    if (waitTicks >= maxWait) {
+	maxWait = waitTicks;
+	peakHolder = holderName;
+    }
+}
+
+//----------------------------------------------------------------------
+// LockProfile::Released
+//	Record that a lock was released after being held "holdTicks".
+//----------------------------------------------------------------------
+
+void
+LockProfile::Released(int holdTicks)
+{
+    totalHold += holdTicks;
+    if (holdTicks > maxHold) {
+	maxHold = holdTicks;
+    }
+}
+
+//----------------------------------------------------------------------
+// LockProfiler::LockProfiler
+//	Start profiling; "top" is how many profiles Print prints.
+//----------------------------------------------------------------------
+
+LockProfiler::LockProfiler(int top)
+{
+    ASSERT(top > 0);
+    profiles = new List<LockProfile *>;
+    topN = top;
+}
+
+//----------------------------------------------------------------------
+// LockProfiler::~LockProfiler
+//	De-allocate the profiles.  Nothing may use them afterwards.
+//----------------------------------------------------------------------
+
+LockProfiler::~LockProfiler()
+{
+    while (!profiles->IsEmpty()) {
+	delete profiles->RemoveFront();
+    }
+    delete profiles;
+}
+
+//----------------------------------------------------------------------
+// LockProfiler::Register
+//	Return the profile of the locks (or semaphores, if not "isLock")
+//	named "name", starting one if this is the first.  This is done
+//	when a lock is created, so the linear search is off the
+//	Acquire path.
+//----------------------------------------------------------------------
+
+LockProfile *
+LockProfiler::Register(char *name, bool isLock)
+{
+    ListIterator<LockProfile *> iter(profiles);
+    LockProfile *profile;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	profile = iter.Item();
+	if (profile->lock == isLock && strcmp(profile->name, name) == 0) {
+	    return profile;
+	}
+    }
+    profile = new LockProfile(name, isLock);
+    profiles->Append(profile);
+    return profile;
+}
+
+//----------------------------------------------------------------------
+// MoreContended
+//	Compare two profiles for sorting: the one that waited more
+//	times comes first, and of those, the one that waited longer.
+//----------------------------------------------------------------------
+
+static int
+MoreContended(LockProfile *a, LockProfile *b)
+{
+    if (a->contended != b->contended) {
+	return b->contended - a->contended;
+    }
+    return b->totalWait - a->totalWait;
+}
+
+//----------------------------------------------------------------------
+// LongerWaits
+//	Compare two profiles for sorting: the one that waited longer in
+//	total comes first, and of those, the one that waited more times.
+//----------------------------------------------------------------------
+
+static int
+LongerWaits(LockProfile *a, LockProfile *b)
+{
+    if (a->totalWait != b->totalWait) {
+	return b->totalWait - a->totalWait;
+    }
+    return b->contended - a->contended;
+}
+
+//----------------------------------------------------------------------
+// LockProfiler::Print
+//	Print the "topN" most contended locks, then the "topN" semaphores
+//	waited on longest, one line each.
+//----------------------------------------------------------------------
+
+void
+LockProfiler::Print()
+{
+    PrintTop(TRUE);
+    PrintTop(FALSE);
+}
+
+//----------------------------------------------------------------------
+// LockProfiler::PrintTop
+//	Print the "topN" most contended locks, or if not "locks", the
+//	"topN" semaphores waited on longest.  Ticks held are only known
+//	for locks.
+//----------------------------------------------------------------------
+
+void
+LockProfiler::PrintTop(bool locks)
+{
+    SortedList<LockProfile *> sorted(locks ? MoreContended : LongerWaits);
+    ListIterator<LockProfile *> iter(profiles);
+    int printed = 0;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	if (iter.Item()->lock == locks && iter.Item()->acquires > 0) {
+	    sorted.Insert(iter.Item());
+	}
+    }
+    if (locks) {
+	cout << "Most contended locks:\n";
+    } else {
+	cout << "Longest semaphore waits (events, not contention):\n";
+    }
+    while (!sorted.IsEmpty() && printed < topN) {
+	LockProfile *p = sorted.RemoveFront();
+
+	cout << "  " << p->name;
+	cout << (p->lock ? ": acquired " : ": P'ed ") << p->acquires;
+	cout << ", waited " << p->contended;
+	cout << ", wait ticks " << p->totalWait << " (max " << p->maxWait;
+	if (p->peakHolder != NULL) {
+	    cout << ", for " << p->peakHolder;
+	}
+	cout << ")";
+	if (p->lock) {
+	    cout << ", hold ticks " << p->totalHold;
+	    cout << " (max " << p->maxHold << ")";
+	}
+	cout << "\n";
+	printed++;
+    }
+}
@@ -0,0 +1,68 @@
+// lockprof.h
+//	Data structures to profile contention on locks and semaphores.
+//
+//	With -lockprof <n>, every Lock and Semaphore counts how often it
+//	was acquired (P'ed), how often that had to wait, and for how long;
+//	locks also count how long they were held.  Locks and semaphores
+//	with the same debug name share one profile, so, for instance, all
+//	"synch disk lock"s add up.  At halt, the <n> most contended locks
+//	are printed, then, separately, the <n> semaphores waited on the
+//	longest.  A semaphore wait is not contention: most semaphores
+//	stand for an event ("synch disk", "console in"), which a thread
+//	always waits for, so they are not ranked with the locks.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef LOCKPROF_H
+#define LOCKPROF_H
+
+#include "copyright.h"
+#include "list.h"
+
+// The following class defines the profile of the locks (or the
+// semaphores) with one name.
+
+class LockProfile {
+  public:
+    LockProfile(char *debugName, bool isLock);
+
+    void Acquired(bool waited, int waitTicks, char *holderName);
+    				// acquired, after "waitTicks" (if it
+				// "waited") for "holderName"
+    void Released(int holdTicks);
+    				// released, after "holdTicks"
+
+    char *name;			// debug name of the locks
+    bool lock;			// locks, or semaphores?
+    int acquires;		// times acquired (or P'ed)
+    int contended;		// of those, times that had to wait
+    int totalWait;		// ticks spent waiting, in total
+    int maxWait;		// and the longest wait
+    char *peakHolder;		// the thread waited for then, if known
+    int totalHold;		// ticks held, in total (locks only)
+    int maxHold;		// and the longest
+};
+
+// The following class defines the profiles of all locks and
+// semaphores.
+
+class LockProfiler {
+  public:
+    LockProfiler(int top);	// print the "top" most contended
+    ~LockProfiler();
+
+    LockProfile *Register(char *name, bool isLock);
+    				// the profile for "name", new if need be
+    void Print();		// the most contended locks, and the
+				// semaphores waited on longest
+
+  private:
+    List<LockProfile *> *profiles;
+    int topN;
+
+    void PrintTop(bool locks);	// the top locks, or semaphores
+};
+
+#endif // LOCKPROF_H
@@ -7,18 +7,53 @@
 //              -f -cp <unix file> <nachos file>
 //              -p <nachos file> -r <nachos file> -l -D
 //              -n <network reliability> -m <machine id>
-//              -z -K -C -N
+//              -z -K -C -N -replay <trace file> -record <trace file>
+//              -quantum <L1> <L2> <L3> -aging <ticks> <step>
+//              -bands <L2 lowest> <L1 lowest> -alpha <weight>
+//              -predict <predictor> -window <bursts>
+//              -group <name> <share> <quota> -gwindow <ticks>
+//              -wakeboost <boost> <decay> -stackpool <stacks>
+//              -lockprof <locks>
+//              -workload <trace file> <threads> <burst> <I/O> <gap> <bursts>
+//              -wprio <low> <high> -B <iterations>
 //
 //    -d causes certain debugging messages to be printed (see debug.h)
 //    -rs causes Yield to occur at random (but repeatable) spots
 //    -z prints the copyright message
 //    -s causes user programs to be executed in single-step mode
+//    -sched selects the scheduling policy (fifo, rr, priority, sjf, mlfq, cfs,
+//		stride)
+//    -record records a trace of every thread's CPU bursts and I/O waits
+//    -replay replays a recorded trace through the scheduler, then halts
+//    -workload generates a synthetic workload (see workload.h) into a
+//		trace file, and replays it
+//    -wprio sets the range of priorities of the generated threads,
+//		0 <= low <= high <= the highest priority
+//    -quantum sets the time slice on each level of the multilevel queue
+//    -aging raises a waiting thread's priority by <step> every <ticks>
+//    -bands sets the lowest priority on L2 and on L1 of the multilevel queue
+//    -alpha sets the weight of the latest CPU burst in the burst estimate
+//    -predict selects the CPU burst predictor (ewma, window, median)
+//    -window sets how many bursts the window and median predictors use
+//    -group starts a process group (see procgroup.h) with a CPU share
+//		and a quota per window (0 for none); the -e and -ep
+//		programs after it belong to it
+//    -gwindow sets the accounting window of process groups
+//    -wakeboost raises the priority of threads woken by I/O by <boost>,
+//		taking <decay> off again every timer tick they run
+//    -lockprof profiles contention on every lock and semaphore, and
+//		prints the <locks> most contended locks at halt, and the
+//		<locks> semaphores waited on longest
+//    -stackpool sets how many free thread stacks of each size are kept
+//		for reuse (0 frees every stack right away)
 //    -x runs a user program
 //    -ci specify file for console input (stdin is the default)
 //    -co specify file for console output (stdout is the default)
 //    -n sets the network reliability
 //    -m sets this machine's host id (needed for the network)
 //    -K run a simple self test of kernel threads and synchronization
+//    -B times kernel threads and synchronization, repeating each
+//		operation <iterations> times (see microbench.h)
 //    -C run an interactive console test
 //    -N run a two-machine network test (see Kernel::NetworkTest)
 //
@@ -45,6 +80,7 @@
 #include "filesys.h"
 #include "openfile.h"
 #include "sysdep.h"
+#include "workload.h"
 
 // global variables
 Kernel *kernel;
@@ -170,8 +206,13 @@ main(int argc, char **argv)
     char *debugArg = "";
     char *userProgName = NULL;        // default is not to execute a user prog
     bool threadTestFlag = false;
+    int benchIterations = 0;          // if > 0, run the microbenchmarks
     bool consoleTestFlag = false;
     bool networkTestFlag = false;
+    char *replayFileName = NULL;      // scheduling trace to replay
+    char *workloadFileName = NULL;    // synthetic workload to generate
+    int workloadArgs[5];              // threads, burst, I/O, gap, bursts
+    int lowPriority = -1, highPriority = -1;  // of the workload threads
 #ifndef FILESYS_STUB
     char *copyUnixFileName = NULL;    // UNIX file to be copied into Nachos
     char *copyNachosFileName = NULL;  // name of copied file in Nachos
@@ -201,12 +242,35 @@ main(int argc, char **argv)
 	else if (strcmp(argv[i], "-K") == 0) {
 	    threadTestFlag = TRUE;
 	}
+	else if (strcmp(argv[i], "-B") == 0) {
+	    ASSERT(i + 1 < argc);
+	    benchIterations = atoi(argv[i + 1]);
+	    i++;
+	}
 	else if (strcmp(argv[i], "-C") == 0) {
 	    consoleTestFlag = TRUE;
 	}
 	else if (strcmp(argv[i], "-N") == 0) {
 	    networkTestFlag = TRUE;
 	}
+	else if (strcmp(argv[i], "-replay") == 0) {
+	    ASSERT(i + 1 < argc);
+	    replayFileName = argv[i + 1];
+	    i++;
+	}
+	else if (strcmp(argv[i], "-workload") == 0) {
+	    ASSERT(i + 6 < argc);
+	    workloadFileName = argv[++i];
+	    for (int j = 0; j < 5; j++) {
+		workloadArgs[j] = atoi(argv[++i]);
+	    }
+	}
+	else if (strcmp(argv[i], "-wprio") == 0) {
+	    ASSERT(i + 2 < argc);
+	    lowPriority = atoi(argv[++i]);
+	    highPriority = atoi(argv[++i]);
+	    ASSERT(lowPriority >= 0 && lowPriority <= highPriority);
+	}
 #ifndef FILESYS_STUB
 	else if (strcmp(argv[i], "-cp") == 0) {
 	    ASSERT(i + 2 < argc);
@@ -234,7 +298,10 @@ main(int argc, char **argv)
 	else if (strcmp(argv[i], "-u") == 0) {
             cout << "Partial usage: nachos [-z -d debugFlags]\n";
             cout << "Partial usage: nachos [-x programName]\n";
-	    cout << "Partial usage: nachos [-K] [-C] [-N]\n";
+	    cout << "Partial usage: nachos [-K] [-B iterations] [-C] [-N]\n";
+	    cout << "Partial usage: nachos [-replay traceFile]\n";
+	    cout << "Partial usage: nachos [-workload traceFile threads burst "
+		 << "io gap bursts] [-wprio low high]\n";
 #ifndef FILESYS_STUB
             cout << "Partial usage: nachos [-cp UnixFile NachosFile]\n";
             cout << "Partial usage: nachos [-p fileName] [-r fileName]\n";
@@ -258,12 +325,30 @@ main(int argc, char **argv)
     if (threadTestFlag) {
       kernel->ThreadSelfTest();  // test threads and synchronization
     }
+    if (benchIterations > 0) {
+      kernel->MicroBenchmark(benchIterations);  // time them
+    }
     if (consoleTestFlag) {
       kernel->ConsoleTest();   // interactive test of the synchronized console
     }
     if (networkTestFlag) {
       kernel->NetworkTest();   // two-machine test of the network
     }
+    if (workloadFileName != NULL) {
+      Workload *workload = new Workload(workloadArgs[0], workloadArgs[1],
+			workloadArgs[2], workloadArgs[3], workloadArgs[4]);
+      if (lowPriority >= 0) {
+	workload->SetPriorities(lowPriority, highPriority);
+      }
+      workload->Write(workloadFileName);  // generate the workload...
+      delete workload;
+      if (replayFileName == NULL) {
+	replayFileName = workloadFileName;  // ...and benchmark it
+      }
+    }
+    if (replayFileName != NULL) {
+      ReplayTrace(replayFileName);   // replay a scheduling trace; halts
+    }
 
 #ifndef FILESYS_STUB
     if (removeFileName != NULL) {
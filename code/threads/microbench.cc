@@ -0,0 +1,427 @@
+// microbench.cc
+//	Routines to time the thread primitives: fork and finish, yield,
+//	semaphores, locks, condition variables and synchronized lists.
+//
+//	Every benchmark that needs a second thread forks a helper, and
+//	waits for it on "done" before stopping the clock, so that the
+//	helper has finished by the time the next benchmark starts.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "microbench.h"
+#include "synch.h"
+#include "synchlist.h"
+#include "main.h"
+#include <sys/time.h>
+
+// state shared between a benchmark and its helper thread
+
+static int benchIterations;	// how many times the helper loops
+static Semaphore *done;		// the helper has finished
+static Semaphore *ping, *pong;
+static Lock *benchLock;
+static Condition *benchCondition;
+static int turn;		// whose turn it is, for the condition
+static int players[2] = { 0, 1 };
+static SynchList<int> *benchList;
+static const int BenchBatch = 16;	// items per AppendMany/RemoveUpTo
+
+//----------------------------------------------------------------------
+// HostNanoseconds
+//	Return the host time, in nanoseconds.  gettimeofday is only
+//	accurate to a microsecond, but it is available on every host
+//	Nachos builds on; averaged over many iterations, that is enough.
+//----------------------------------------------------------------------
+
+static long long
+HostNanoseconds()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (long long) tv.tv_sec * 1000000000 + (long long) tv.tv_usec * 1000;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::MicroBench
+//	Set up the benchmarks; see microbench.h.
+//----------------------------------------------------------------------
+
+MicroBench::MicroBench(int numIterations)
+{
+    ASSERT(numIterations > 0);
+    iterations = numIterations;
+    startNanos = 0;
+    startTicks = 0;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::Start, MicroBench::Stop
+//	Time a benchmark.  Stop prints the average cost of each of "ops"
+//	operations, as one row of the table.
+//----------------------------------------------------------------------
+
+void
+MicroBench::Start()
+{
+    benchIterations = iterations;
+    startTicks = kernel->stats->totalTicks;
+    startNanos = HostNanoseconds();
+}
+
+void
+MicroBench::Stop(char *name, int ops)
+{
+    long long nanos = HostNanoseconds() - startNanos;
+    int ticks = kernel->stats->totalTicks - startTicks;
+
+    printf("%-24s %8d %12.1f %10.2f\n", name, ops,
+	   (double) nanos / ops, (double) ticks / ops);
+}
+
+//----------------------------------------------------------------------
+// MicroBench::Run
+//	Run every benchmark, one row each.
+//----------------------------------------------------------------------
+
+void
+MicroBench::Run()
+{
+    done = new Semaphore("bench done", 0);
+
+    printf("scheduling policy: %s\n",
+	   kernel->scheduler->getPolicy()->getName());
+    printf("%-24s %8s %12s %10s\n", "benchmark", "ops", "host ns/op",
+	   "ticks/op");
+    ForkFinish();
+    YieldPingPong();
+    SemaphoreHandoff();
+    LockUncontended();
+    LockContended();
+    ConditionSignalWait();
+    SynchListProducerConsumer();
+    SynchListBatch();
+
+    delete done;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::ForkFinish
+//	Fork a thread that does nothing but finish, and wait for it.
+//	This includes two context switches, and the V/P on "done".
+//----------------------------------------------------------------------
+
+static void
+FinishHelper(void *unused)
+{
+    done->V();
+}
+
+void
+MicroBench::ForkFinish()
+{
+    Start();
+    for (int i = 0; i < iterations; i++) {
+	Thread *t = new Thread("bench fork", 1);
+
+	t->Fork((VoidFunctionPtr) FinishHelper, NULL);
+	done->P();
+    }
+    Stop("Fork+Finish", iterations);
+}
+
+//----------------------------------------------------------------------
+// MicroBench::YieldSwitches
+//	Return TRUE if Yield hands the CPU to another ready thread under
+//	the current scheduling policy.  Some policies (-sched fifo, sjf)
+//	never switch on a Yield; timing one there only times a no-op.
+//----------------------------------------------------------------------
+
+static bool switched;		// the probe thread ran during the Yield
+
+static void
+SwitchProbe(void *unused)
+{
+    switched = TRUE;
+    done->V();
+}
+
+bool
+MicroBench::YieldSwitches()
+{
+    Thread *t = new Thread("bench probe", 1);
+    bool result;
+
+    switched = FALSE;
+    t->Fork((VoidFunctionPtr) SwitchProbe, NULL);
+    kernel->currentThread->Yield();
+    result = switched;
+    done->P();
+    return result;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::YieldPingPong
+//	Two threads yield to each other; each Yield is a context switch.
+//	Skipped if Yield does not switch threads (see YieldSwitches).
+//----------------------------------------------------------------------
+
+static void
+YieldHelper(void *unused)
+{
+    for (int i = 0; i < benchIterations; i++) {
+	kernel->currentThread->Yield();
+    }
+    done->V();
+}
+
+void
+MicroBench::YieldPingPong()
+{
+    Thread *t;
+
+    if (!YieldSwitches()) {
+	printf("%-24s (skipped: Yield does not switch under -sched %s)\n",
+	       "Yield ping-pong",
+	       kernel->scheduler->getPolicy()->getName());
+	return;
+    }
+    t = new Thread("bench yield", 1);
+    Start();
+    t->Fork((VoidFunctionPtr) YieldHelper, NULL);
+    for (int i = 0; i < iterations; i++) {
+	kernel->currentThread->Yield();
+    }
+    done->P();
+    Stop("Yield ping-pong", 2 * iterations);
+}
+
+//----------------------------------------------------------------------
+// MicroBench::SemaphoreHandoff
+//	Two threads hand control back and forth with a pair of
+//	semaphores, as in Semaphore::SelfTest.  One operation is a
+//	round trip.
+//----------------------------------------------------------------------
+
+static void
+SemaphoreHelper(void *unused)
+{
+    for (int i = 0; i < benchIterations; i++) {
+	ping->P();
+	pong->V();
+    }
+    done->V();
+}
+
+void
+MicroBench::SemaphoreHandoff()
+{
+    Thread *t = new Thread("bench semaphore", 1);
+
+    ping = new Semaphore("bench ping", 0);
+    pong = new Semaphore("bench pong", 0);
+    Start();
+    t->Fork((VoidFunctionPtr) SemaphoreHelper, NULL);
+    for (int i = 0; i < iterations; i++) {
+	ping->V();
+	pong->P();
+    }
+    done->P();
+    Stop("Semaphore P/V handoff", iterations);
+    delete ping;
+    delete pong;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::LockUncontended
+//	Acquire and release a lock nobody else wants.
+//----------------------------------------------------------------------
+
+void
+MicroBench::LockUncontended()
+{
+    benchLock = new Lock("bench lock");
+    Start();
+    for (int i = 0; i < iterations; i++) {
+	benchLock->Acquire();
+	benchLock->Release();
+    }
+    Stop("Lock uncontended", iterations);
+    delete benchLock;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::LockContended
+//	This thread acquires a lock, wakes the helper, and blocks on a
+//	semaphore while still holding the lock.  The helper lets it go on
+//	and tries to acquire the lock, so it finds the lock busy and has
+//	to wait, whatever the scheduling policy.  One operation is a
+//	contended hand-off of the lock.
+//
+//	Only a timer interrupt between the helper's V and its Acquire
+//	can spoil that; such hand-offs are counted and reported.
+//----------------------------------------------------------------------
+
+static void
+LockHelper(void *unused)
+{
+    for (int i = 0; i < benchIterations; i++) {
+	ping->P();		// the other thread holds the lock
+	pong->V();
+	benchLock->Acquire();
+	benchLock->Release();
+    }
+    done->V();
+}
+
+void
+MicroBench::LockContended()
+{
+    Thread *t = new Thread("bench lock", 1);
+    int contended = 0;
+
+    benchLock = new Lock("bench lock");
+    ping = new Semaphore("bench ping", 0);
+    pong = new Semaphore("bench pong", 0);
+    Start();
+    t->Fork((VoidFunctionPtr) LockHelper, NULL);
+    for (int i = 0; i < iterations; i++) {
+	benchLock->Acquire();
+	ping->V();
+	pong->P();		// block, holding the lock
+	if (t->waitingFor == benchLock) {
+	    contended++;
+	}
+	benchLock->Release();
+    }
+    done->P();
+    Stop("Lock contended", iterations);
+    if (contended < iterations) {
+	printf("%-24s (only %d of %d hand-offs were contended)\n", "",
+	       contended, iterations);
+    }
+    delete ping;
+    delete pong;
+    delete benchLock;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::ConditionSignalWait
+//	Two threads take turns, each signalling the other and waiting
+//	for its own turn on a condition variable.
+//----------------------------------------------------------------------
+
+static void
+ConditionHelper(void *which)
+{
+    int me = *(int *) which;
+
+    for (int i = 0; i < benchIterations; i++) {
+	benchLock->Acquire();
+	while (turn != me) {
+	    benchCondition->Wait(benchLock);
+	}
+	turn = 1 - me;
+	benchCondition->Signal(benchLock);
+	benchLock->Release();
+    }
+    done->V();
+}
+
+void
+MicroBench::ConditionSignalWait()
+{
+    Thread *t = new Thread("bench condition", 1);
+
+    benchLock = new Lock("bench lock");
+    benchCondition = new Condition("bench condition");
+    turn = 0;
+    Start();
+    t->Fork((VoidFunctionPtr) ConditionHelper, (void *) &players[1]);
+    ConditionHelper((void *) &players[0]);
+    done->P();
+    done->P();
+    Stop("Condition signal/wait", 2 * iterations);
+    delete benchCondition;
+    delete benchLock;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::SynchListProducerConsumer
+//	A producer appends to a synchronized list, while this thread
+//	removes the items.
+//----------------------------------------------------------------------
+
+static void
+ProducerHelper(void *unused)
+{
+    for (int i = 0; i < benchIterations; i++) {
+	benchList->Append(i);
+    }
+    done->V();
+}
+
+void
+MicroBench::SynchListProducerConsumer()
+{
+    Thread *t = new Thread("bench producer", 1);
+
+    benchList = new SynchList<int>;
+    Start();
+    t->Fork((VoidFunctionPtr) ProducerHelper, NULL);
+    for (int i = 0; i < iterations; i++) {
+	int item = benchList->RemoveFront();
+	ASSERT(item == i);
+    }
+    done->P();
+    Stop("SynchList produce/consume", iterations);
+    delete benchList;
+}
+
+//----------------------------------------------------------------------
+// MicroBench::SynchListBatch
+//	As SynchListProducerConsumer, but the items move in batches, with
+//	AppendMany and RemoveUpTo, through a bounded list.  One operation
+//	is still one item, so the two rows can be compared directly.
+//----------------------------------------------------------------------
+
+static void
+BatchProducerHelper(void *unused)
+{
+    int items[BenchBatch];
+
+    for (int i = 0; i < benchIterations; ) {
+	int n = 0;
+
+	while (n < BenchBatch && i < benchIterations) {
+	    items[n++] = i++;
+	}
+	benchList->AppendMany(items, n);
+    }
+    done->V();
+}
+
+void
+MicroBench::SynchListBatch()
+{
+    Thread *t = new Thread("bench batch producer", 1);
+    int items[BenchBatch];
+
+    benchList = new SynchList<int>(4 * BenchBatch);
+    Start();
+    t->Fork((VoidFunctionPtr) BatchProducerHelper, NULL);
+    for (int i = 0; i < iterations; ) {
+	int n = benchList->RemoveUpTo(items, BenchBatch);
+
+	for (int j = 0; j < n; j++) {
+	    ASSERT(items[j] == i++);
+	}
+    }
+    done->P();
+    Stop("SynchList batched", iterations);
+    delete benchList;
+}
@@ -0,0 +1,56 @@
+// microbench.h
+//	Data structures to measure the cost of the thread primitives.
+//
+//	The self tests (-K) only check that threads and synchronization
+//	work; these benchmarks time them, so a change to the kernel can
+//	be compared against a baseline:
+//
+//		nachos -B 10000
+//
+//	Each benchmark repeats one operation "iterations" times, and
+//	reports the average cost of the operation both in host time
+//	(nanoseconds, as measured by the UNIX clock) and in simulated
+//	time (ticks).  Nachos runs on a single UNIX thread, so host time
+//	is the time the kernel itself spends, plus the context switches
+//	(see switch.s).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include "copyright.h"
+
+// The following class runs the benchmarks and prints the results.
+
+class MicroBench {
+  public:
+    MicroBench(int numIterations);	// repeat each operation this often
+
+    void Run();			// run every benchmark, print a table
+
+  private:
+    int iterations;		// how many times to repeat each operation
+    long long startNanos;	// host time when the benchmark started
+    int startTicks;		// simulated time when it started
+
+    void Start();		// start timing a benchmark
+    void Stop(char *name, int ops);
+    				// stop timing, and print a row of the
+				// table: "ops" operations were timed
+
+    bool YieldSwitches();	// does Yield run another thread?
+
+    void ForkFinish();		// the benchmarks
+    void YieldPingPong();
+    void SemaphoreHandoff();
+    void LockUncontended();
+    void LockContended();
+    void ConditionSignalWait();
+    void SynchListProducerConsumer();
+    void SynchListBatch();
+};
+
+#endif // MICROBENCH_H
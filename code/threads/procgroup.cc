@@ -0,0 +1,333 @@
+// procgroup.cc
+//	Routines to account for the CPU use of process groups, and to
+//	hold back the threads of groups that are over their share or
+//	quota.  See procgroup.h.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "procgroup.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// ProcessGroup::ProcessGroup
+//	Initialize a process group with no threads.  "cpuQuota" is the
+//	most CPU ticks the group may use per window, 0 for no limit.
+//----------------------------------------------------------------------
+
+ProcessGroup::ProcessGroup(int groupID, char *groupName, int cpuShare,
+			   int cpuQuota)
+{
+    ASSERT(cpuShare > 0 && cpuQuota >= 0);
+    id = groupID;
+    name = groupName;
+    share = cpuShare;
+    quota = cpuQuota;
+    used = 0;
+    members = 0;
+    ready = 0;
+    throttled = new IntrusiveList<Thread *>(QueueLink);
+    usage = NULL;
+}
+
+//----------------------------------------------------------------------
+// ProcessGroup::~ProcessGroup
+//	De-allocate a process group.  Its usage record belongs to
+//	Statistics.
+//----------------------------------------------------------------------
+
+ProcessGroup::~ProcessGroup()
+{
+    delete throttled;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::GroupScheduler
+//	Initialize the (empty) list of groups; the first window starts
+//	now.
+//----------------------------------------------------------------------
+
+GroupScheduler::GroupScheduler()
+{
+    groups = new List<ProcessGroup *>;
+    windowStart = 0;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::~GroupScheduler
+//	De-allocate the list of groups (but not the groups, which belong
+//	to the Kernel).
+//----------------------------------------------------------------------
+
+GroupScheduler::~GroupScheduler()
+{
+    delete groups;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Join
+//	"thread" was just forked into thread->group; start charging the
+//	group for it.
+//----------------------------------------------------------------------
+
+void
+GroupScheduler::Join(Thread* thread)
+{
+    ProcessGroup *group = thread->group;
+
+    if (group->usage == NULL) {		// first thread of the group
+	group->usage = kernel->stats->NewGroup(group->id, group->name,
+					       group->share, group->quota);
+	groups->Append(group);
+    }
+    group->members++;
+    group->usage->threads++;
+    thread->groupCharged = thread->cpuTicks;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Charge
+//	Bill the group of "thread" for the CPU ticks the thread used
+//	since it was last charged.
+//----------------------------------------------------------------------
+
+void
+GroupScheduler::Charge(Thread* thread)
+{
+    int ticks = thread->cpuTicks - thread->groupCharged;
+
+    thread->group->used += ticks;
+    thread->group->usage->cpuTicks += ticks;
+    thread->groupCharged = thread->cpuTicks;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Rollover
+//	If the current window is over, start the one that contains now:
+//	every group gets its full share and quota back.
+//----------------------------------------------------------------------
+
+void
+GroupScheduler::Rollover()
+{
+    int window = kernel->schedParams->groupWindow;
+    int now = kernel->stats->totalTicks;
+    ListIterator<ProcessGroup *> iter(groups);
+
+    if (now < windowStart + window) {
+	return;
+    }
+    windowStart += ((now - windowStart) / window) * window;
+    for (; !iter.IsDone(); iter.Next()) {
+	iter.Item()->used = 0;
+    }
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::OverQuota
+//	Return TRUE if the group of "thread" has used up its quota for
+//	this window.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::OverQuota(Thread* thread)
+{
+    ProcessGroup *group = thread->group;
+
+    if (group == NULL) {
+	return FALSE;
+    }
+    Rollover();
+    return group->quota > 0 && group->used >= group->quota;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::OverShare
+//	Return TRUE if "group" has used at least its share of this window,
+//	counting only the groups that still have threads.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::OverShare(ProcessGroup* group)
+{
+    ListIterator<ProcessGroup *> iter(groups);
+    int shares = 0;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	if (iter.Item()->members > 0) {
+	    shares += iter.Item()->share;
+	}
+    }
+    return shares > 0 && group->used >=
+	((double) kernel->schedParams->groupWindow * group->share) / shares;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Contended
+//	Return TRUE if some other group, under its share and its quota,
+//	has a thread on the ready list -- that is, if "group" running
+//	over its share would take CPU time from somebody entitled to it.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::Contended(ProcessGroup* group)
+{
+    ListIterator<ProcessGroup *> iter(groups);
+    ProcessGroup *other;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	other = iter.Item();
+	if (other != group && other->ready > 0 && !OverShare(other) &&
+	    (other->quota == 0 || other->used < other->quota)) {
+	    return TRUE;
+	}
+    }
+    return FALSE;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Hold
+//	Hold "thread" back, off the policy's ready list.
+//----------------------------------------------------------------------
+
+void
+GroupScheduler::Hold(Thread* thread)
+{
+    DEBUG(dbgThread, "Throttling " << thread->getName() << " of group "
+	  << thread->group->name << " (used " << thread->group->used << ")");
+    thread->group->throttled->Append(thread);
+    thread->group->usage->throttles++;
+    thread->throttledSince = kernel->stats->totalTicks;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Throttle
+//	"thread" is ready to run.  If its group is over quota, hold it
+//	back until the next window.
+//
+// Returns:
+//	TRUE if the thread was held back; FALSE if it should go on the
+//	policy's ready list.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::Throttle(Thread* thread)
+{
+    if (OverQuota(thread)) {
+	Hold(thread);
+	return TRUE;
+    }
+    thread->group->ready++;
+    return FALSE;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Release
+//	Find a held-back thread that may go back on the policy's ready
+//	list: its group is under quota, and either under its share or
+//	not keeping anybody else from theirs.  If "idle" (the policy has
+//	nothing to run), being over share doesn't matter.
+//
+// Returns:
+//	The thread, or NULL if there is none.
+//----------------------------------------------------------------------
+
+Thread *
+GroupScheduler::Release(bool idle)
+{
+    ListIterator<ProcessGroup *> iter(groups);
+    ProcessGroup *group;
+    Thread *thread;
+
+    Rollover();
+    for (; !iter.IsDone(); iter.Next()) {
+	group = iter.Item();
+	if (group->throttled->IsEmpty() ||
+	    (group->quota > 0 && group->used >= group->quota) ||
+	    (!idle && OverShare(group) && Contended(group))) {
+	    continue;
+	}
+	thread = group->throttled->RemoveFront();
+	group->usage->throttledTicks +=
+	    kernel->stats->totalTicks - thread->throttledSince;
+	group->ready++;
+	return thread;
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::Picked
+//	The policy picked "thread" to run next.  Hold it back instead if
+//	its group has run out of quota since, or is over its share while
+//	another group is waiting for its own.
+//
+// Returns:
+//	TRUE if the thread may run.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::Picked(Thread* thread)
+{
+    ProcessGroup *group = thread->group;
+
+    group->ready--;
+    if (OverQuota(thread) || (OverShare(group) && Contended(group))) {
+	Hold(thread);
+	return FALSE;
+    }
+    return TRUE;
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::OverLimit
+//	On a timer tick, charge the running thread's group, and decide
+//	whether the thread should give up the CPU: its group is out of
+//	quota, or over its share while another group is waiting.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::OverLimit(Thread* current)
+{
+    ProcessGroup *group = current->group;
+
+    Rollover();
+    Charge(current);
+    return OverQuota(current) || (OverShare(group) && Contended(group));
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::IsThrottled
+//	Return TRUE if "thread" is being held back.
+//----------------------------------------------------------------------
+
+bool
+GroupScheduler::IsThrottled(Thread* thread)
+{
+    return thread->group != NULL && thread->group->throttled->IsInList(thread);
+}
+
+//----------------------------------------------------------------------
+// GroupScheduler::OnBlock, GroupScheduler::OnFinish
+//	The running thread stops being runnable; charge its group.  A
+//	thread that finishes leaves the group, so the group no longer
+//	counts when the shares are divided up.
+//----------------------------------------------------------------------
+
+void
+GroupScheduler::OnBlock(Thread* thread)
+{
+    Rollover();
+    Charge(thread);
+}
+
+void
+GroupScheduler::OnFinish(Thread* thread)
+{
+    Rollover();
+    Charge(thread);
+    thread->group->members--;
+}
@@ -0,0 +1,101 @@
+// procgroup.h
+//	Data structures for process groups: sets of threads that share
+//	a CPU allotment, so that one busy group cannot starve the others.
+//
+//	Every group has a CPU "share", and optionally a hard "quota":
+//
+//	  - CPU time is accounted in windows (-gwindow ticks, 1000 by
+//	    default).  Within a window, a group is entitled to its share
+//	    of the window, relative to the shares of the other groups
+//	    that still have threads.  A group over its share is held
+//	    back ("throttled") only while a group under its share has a
+//	    thread ready; otherwise it may use the idle CPU.
+//
+//	  - A group that has used its quota for the window is throttled
+//	    until the next window, even if the CPU has to go idle.
+//
+//	Threads of throttled groups wait off the policy's ready list;
+//	the policy never sees them.  Threads that belong to no group
+//	(the default) are never throttled.
+//
+//	Groups are made with "-group <name> <share> <quota>" on the
+//	command line; the programs named by the -e and -ep flags that
+//	follow it belong to it, and so does every thread they fork.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef PROCGROUP_H
+#define PROCGROUP_H
+
+#include "copyright.h"
+#include "list.h"
+#include "intrusivelist.h"
+#include "thread.h"
+#include "stats.h"
+
+// Most groups there can be
+const int MaxGroups = 10;
+
+// The following class is a process group.
+
+class ProcessGroup {
+  public:
+    ProcessGroup(int groupID, char *groupName, int cpuShare, int cpuQuota);
+    ~ProcessGroup();
+
+    int id;			// the group's ID
+    char *name;			// the group's name
+    int share;			// relative CPU share
+    int quota;			// most CPU ticks per window, 0 if none
+    int used;			// CPU ticks used this window
+    int members;		// threads that haven't finished
+    int ready;			// members on the policy's ready list
+    IntrusiveList<Thread *> *throttled;	// members held back
+    GroupUsage *usage;		// totals, for Statistics; NULL until
+				// the first thread joins
+};
+
+// The following class keeps track of the process groups, and decides
+// when their threads have to be held back.  The Scheduler asks it
+// before and after the policy.
+
+class GroupScheduler {
+  public:
+    GroupScheduler();
+    ~GroupScheduler();
+
+    void Join(Thread* thread);	// thread, of thread->group, arrived
+    bool Throttle(Thread* thread);
+    				// thread is ready; hold it back (and
+				// return TRUE) if its group is over quota
+    Thread* Release(bool idle);	// a held-back thread that may now go
+				// back to the policy, or NULL; "idle"
+				// if the policy has nothing else
+    bool Picked(Thread* thread);// the policy picked thread; FALSE if it
+				// has been held back instead
+    bool OverLimit(Thread* current);
+    				// timer tick: should current give way?
+    bool OverQuota(Thread* thread);
+    				// has thread's group used its quota?
+    bool IsThrottled(Thread* thread);
+    				// is thread being held back?
+    void OnBlock(Thread* thread);	// thread is going to sleep
+    void OnFinish(Thread* thread);	// thread is done for good
+
+  private:
+    List<ProcessGroup *> *groups;	// every group that had a thread
+    int windowStart;		// when the current window started
+
+    void Charge(Thread* thread);// bill thread's group for its CPU time
+    void Rollover();		// start a new window, if it is time
+    bool OverShare(ProcessGroup* group);
+    				// used more than its share this window?
+    bool Contended(ProcessGroup* group);
+    				// does a group under its share have a
+				// thread ready?
+    void Hold(Thread* thread);	// hold thread back
+};
+
+#endif // PROCGROUP_H
@@ -0,0 +1,134 @@
+// proctable.cc
+//	Routines to allocate and look up process IDs.  See proctable.h.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "proctable.h"
+
+const int InitialTableSize = 16;	// slots to start with
+const int PidInUse = -2;		// nextFree of a PID in use (-1 ends
+					// the free list)
+
+//----------------------------------------------------------------------
+// ProcessTable::ProcessTable
+//	Initialize an empty process table.
+//----------------------------------------------------------------------
+
+ProcessTable::ProcessTable()
+{
+    size = 0;
+    threads = NULL;
+    nextFree = NULL;
+    firstFree = -1;
+    inUse = 0;
+    Grow();
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::~ProcessTable
+//	De-allocate the table (but not the threads in it).
+//----------------------------------------------------------------------
+
+ProcessTable::~ProcessTable()
+{
+    delete [] threads;
+    delete [] nextFree;
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::Grow
+//	Double the number of slots (or make the first ones), and put the
+//	new ones on the free list, lowest first.
+//----------------------------------------------------------------------
+
+void
+ProcessTable::Grow()
+{
+    int newSize = (size == 0) ? InitialTableSize : size * 2;
+    Thread **newThreads = new Thread *[newSize];
+    int *newNextFree = new int[newSize];
+    int i;
+
+    for (i = 0; i < size; i++) {
+	newThreads[i] = threads[i];
+	newNextFree[i] = nextFree[i];
+    }
+    for (i = size; i < newSize; i++) {
+	newThreads[i] = NULL;
+	newNextFree[i] = (i + 1 < newSize) ? i + 1 : firstFree;
+    }
+    firstFree = size;
+    delete [] threads;
+    delete [] nextFree;
+    threads = newThreads;
+    nextFree = newNextFree;
+    size = newSize;
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::Allocate
+//	Reserve a PID, growing the table if every one is in use.
+//
+// Returns:
+//	The PID.
+//----------------------------------------------------------------------
+
+int
+ProcessTable::Allocate()
+{
+    int pid;
+
+    if (firstFree < 0) {
+	Grow();
+    }
+    pid = firstFree;
+    firstFree = nextFree[pid];
+    nextFree[pid] = PidInUse;
+    inUse++;
+    return pid;
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::Set
+//	Record that "pid", which was allocated, belongs to "thread".
+//----------------------------------------------------------------------
+
+void
+ProcessTable::Set(int pid, Thread *thread)
+{
+    ASSERT(0 <= pid && pid < size && nextFree[pid] == PidInUse);
+    threads[pid] = thread;
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::Lookup
+//	Return the thread with "pid", or NULL if there is none.
+//----------------------------------------------------------------------
+
+Thread *
+ProcessTable::Lookup(int pid)
+{
+    if (pid < 0 || pid >= size) {
+	return NULL;
+    }
+    return threads[pid];
+}
+
+//----------------------------------------------------------------------
+// ProcessTable::Free
+//	"pid" is no longer in use; it will be the next one allocated.
+//----------------------------------------------------------------------
+
+void
+ProcessTable::Free(int pid)
+{
+    ASSERT(0 <= pid && pid < size && nextFree[pid] == PidInUse);
+    threads[pid] = NULL;
+    nextFree[pid] = firstFree;
+    firstFree = pid;
+    inUse--;
+}
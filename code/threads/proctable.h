@@ -0,0 +1,58 @@
+// proctable.h
+//	Data structures for the process table: the map from process IDs
+//	to the threads running them, and the list of programs to run.
+//
+//	A freed PID goes on a free list, and is the next one handed out
+//	(so PIDs stay small).  Lookup is an array index.  The table
+//	grows (doubling) when every slot is in use, so there is no limit
+//	on the number of processes, and no scan to find a free one.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef PROCTABLE_H
+#define PROCTABLE_H
+
+#include "copyright.h"
+#include "thread.h"
+
+class ProcessGroup;
+
+// The following class is a program to run (-e, or -ep with a
+// priority), and the process group to run it in.
+
+class ExecFile {
+  public:
+    ExecFile(char *fileName, int execPriority, ProcessGroup *execGroup)
+	{ name = fileName; priority = execPriority; group = execGroup; }
+
+    char *name;			// the executable
+    int priority;		// priority to start it at
+    ProcessGroup *group;	// process group, NULL if none
+};
+
+// The following class is the process table.
+
+class ProcessTable {
+  public:
+    ProcessTable();		// an empty table
+    ~ProcessTable();
+
+    int Allocate();		// reserve a PID
+    void Set(int pid, Thread *thread);	// pid is thread's
+    Thread *Lookup(int pid);	// the thread with pid, NULL if none
+    void Free(int pid);		// pid is no longer in use
+    int NumInUse() { return inUse; }	// PIDs allocated
+
+  private:
+    Thread **threads;		// thread of each PID (NULL if free)
+    int *nextFree;		// next free PID after each free one
+    int size;			// number of slots
+    int firstFree;		// first free PID, -1 if none
+    int inUse;			// PIDs allocated
+
+    void Grow();		// double the number of slots
+};
+
+#endif // PROCTABLE_H
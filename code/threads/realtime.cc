@@ -0,0 +1,342 @@
+// realtime.cc
+//	The real-time scheduling class: earliest deadline first, with
+//	admission control and per-thread budgets.
+//
+//	These routines assume that interrupts are already disabled;
+//	they are only ever called from the Scheduler.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "realtime.h"
+#include "schedpolicy.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// DeadlineCompare
+//	Ordering for the real-time heaps: earliest deadline first.
+//----------------------------------------------------------------------
+
+static int
+DeadlineCompare(Thread* a, Thread* b)
+{
+    if (a->realTime->deadline > b->realTime->deadline) return 1;
+    if (a->realTime->deadline < b->realTime->deadline) return -1;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// RealTimeRecord::RealTimeRecord
+//	Start keeping track of real-time "thread".
+//----------------------------------------------------------------------
+
+RealTimeRecord::RealTimeRecord(Thread *t)
+{
+    thread = t;
+    id = t->getID();
+    name = t->getName();
+    period = 0;
+    budget = 0;
+    deadline = 0;
+    used = 0;
+    charged = t->cpuTicks;
+    periods = 0;
+    misses = 0;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::RealTimeClass
+//	Initialize the real-time class; nobody admitted yet.
+//----------------------------------------------------------------------
+
+RealTimeClass::RealTimeClass()
+{
+    records = new List<RealTimeRecord *>;
+    readyList = new Heap<Thread *>(DeadlineCompare, ReadyIndex);
+    throttled = new Heap<Thread *>(DeadlineCompare, ReadyIndex);
+    utilization = 0;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::~RealTimeClass
+//	De-allocate the real-time class.
+//----------------------------------------------------------------------
+
+RealTimeClass::~RealTimeClass()
+{
+    while (!records->IsEmpty()) {
+	delete records->RemoveFront();
+    }
+    delete records;
+    delete readyList;
+    delete throttled;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::Admit
+//	Reserve "budget" ticks of CPU every "period" ticks for "thread",
+//	starting now, or -- if "period" is 0 -- take it out of the
+//	real-time class.  The thread must be running.
+//
+//	The reservation is refused if it would bring the total
+//	utilization above 1.
+//
+// Returns:
+//	0 if the reservation was made, -1 if not.
+//----------------------------------------------------------------------
+
+int
+RealTimeClass::Admit(Thread* thread, int period, int budget)
+{
+    RealTimeRecord *rec = thread->realTime;
+    double old = 0;
+
+    if (period == 0) {
+	if (rec != NULL) {
+	    Charge(thread);
+	    Withdraw(rec);
+	}
+	return 0;
+    }
+    if (period < 1 || budget < 1 || budget > period) {
+	return -1;
+    }
+    if (rec != NULL) {
+	old = (double) rec->budget / rec->period;
+    }
+    if (utilization - old + (double) budget / period > 1.0 + 1e-9) {
+	DEBUG(dbgThread, "Real-time reservation of " << budget << "/"
+	      << period << " refused for " << thread->getName());
+	return -1;
+    }
+    if (rec == NULL) {
+	rec = new RealTimeRecord(thread);
+	records->Append(rec);
+	thread->realTime = rec;
+    }
+    Charge(thread);
+    utilization += (double) budget / period - old;
+    rec->period = period;
+    rec->budget = budget;
+    rec->deadline = kernel->stats->totalTicks + period;
+    rec->used = 0;
+    rec->periods++;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::Withdraw
+//	Take the thread of "rec" out of the real-time class.  Its
+//	numbers stay around for the report at halt.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::Withdraw(RealTimeRecord *rec)
+{
+    utilization -= (double) rec->budget / rec->period;
+    if (utilization < 0) {		// rounding
+	utilization = 0;
+    }
+    rec->thread->realTime = NULL;
+    rec->thread = NULL;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::Charge
+//	Bill "thread" for the CPU ticks it used since it was last
+//	charged.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::Charge(Thread* thread)
+{
+    RealTimeRecord *rec = thread->realTime;
+
+    rec->used += thread->cpuTicks - rec->charged;
+    rec->charged = thread->cpuTicks;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::NextPeriod
+//	Move "rec" on to the period that contains "now", with a fresh
+//	budget.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::NextPeriod(RealTimeRecord *rec, int now)
+{
+    int elapsed = (now - rec->deadline) / rec->period + 1;
+
+    rec->deadline += elapsed * rec->period;
+    rec->periods += elapsed;
+    rec->used = 0;
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::Release
+//	Start a new period for every waiting thread whose deadline has
+//	passed: throttled threads get their budget back, and ready
+//	threads that never got theirs have missed the deadline.
+//
+//	Both heaps are ordered by deadline, so this only looks at the
+//	threads it moves, plus one.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::Release()
+{
+    int now = kernel->stats->totalTicks;
+    Thread *t;
+
+    while (!readyList->IsEmpty() &&
+	   readyList->Front()->realTime->deadline <= now) {
+	t = readyList->RemoveFront();
+	t->realTime->misses++;
+	DEBUG(dbgThread, "Real-time thread " << t->getName()
+	      << " missed its deadline at " << t->realTime->deadline);
+	NextPeriod(t->realTime, now);
+	readyList->Insert(t);
+    }
+    while (!throttled->IsEmpty() &&
+	   throttled->Front()->realTime->deadline <= now) {
+	t = throttled->RemoveFront();
+	NextPeriod(t->realTime, now);
+	readyList->Insert(t);
+    }
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::ReadyToRun
+//	Put a real-time thread on the ready heap -- or, if it has used
+//	up its budget for this period, on the throttled heap.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::ReadyToRun(Thread* thread)
+{
+    RealTimeRecord *rec = thread->realTime;
+    int now = kernel->stats->totalTicks;
+
+    if (rec->deadline <= now) {		// woke up in a later period
+	NextPeriod(rec, now);
+    }
+    if (rec->used < rec->budget) {
+	readyList->Insert(thread);
+    } else {
+	throttled->Insert(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::PickNext
+//	Dequeue the ready real-time thread with the earliest deadline.
+//
+// Returns:
+//	The thread, or NULL if no real-time thread is ready.
+//----------------------------------------------------------------------
+
+Thread *
+RealTimeClass::PickNext()
+{
+    Release();
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    return readyList->RemoveFront();
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::OnTick
+//	Decide whether the running thread should give way to a real-time
+//	thread.
+//
+//	A real-time thread gives way when it runs out of budget, or
+//	when another has an earlier deadline; anyone else, as soon as a
+//	real-time thread is ready.
+//----------------------------------------------------------------------
+
+bool
+RealTimeClass::OnTick(Thread* current)
+{
+    RealTimeRecord *rec = current->realTime;
+    int now = kernel->stats->totalTicks;
+
+    Release();
+    if (rec == NULL) {
+	return !readyList->IsEmpty();
+    }
+    Charge(current);
+    if (rec->deadline <= now) {
+	if (rec->used < rec->budget) {
+	    rec->misses++;
+	    DEBUG(dbgThread, "Real-time thread " << current->getName()
+		  << " missed its deadline at " << rec->deadline);
+	}
+	NextPeriod(rec, now);
+    }
+    return rec->used >= rec->budget || (!readyList->IsEmpty() &&
+	readyList->Front()->realTime->deadline < rec->deadline);
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::OnBlock, RealTimeClass::OnFinish
+//	The running real-time thread stops being runnable.  A thread
+//	that finishes gives its reservation back.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::OnBlock(Thread* thread)
+{
+    Charge(thread);
+}
+
+void
+RealTimeClass::OnFinish(Thread* thread)
+{
+    Charge(thread);
+    Withdraw(thread->realTime);
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::Print
+//	Print the ready and throttled real-time threads.  For debugging.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::Print()
+{
+    cout << "Real-time: ";
+    readyList->Apply(ThreadPrint);
+    cout << "\nThrottled: ";
+    throttled->Apply(ThreadPrint);
+    cout << "\n";
+}
+
+//----------------------------------------------------------------------
+// RealTimeClass::PrintStats
+//	Print, for every thread that was ever real-time, its reservation
+//	and how many of its deadlines it missed.  Called at halt.
+//----------------------------------------------------------------------
+
+void
+RealTimeClass::PrintStats()
+{
+    ListIterator<RealTimeRecord *> iter(records);
+    RealTimeRecord *rec;
+
+    if (records->IsEmpty()) {
+	return;
+    }
+    cout << "Real-time threads, utilization still reserved "
+	 << utilization << ":\n";
+    cout << "Thread\tPeriod\tBudget\tPeriods\tMissed\tName\n";
+    for (; !iter.IsDone(); iter.Next()) {
+	rec = iter.Item();
+	cout << rec->id << "\t" << rec->period << "\t" << rec->budget
+	     << "\t" << rec->periods << "\t" << rec->misses
+	     << "\t" << rec->name << "\n";
+    }
+}
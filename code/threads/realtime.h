@@ -0,0 +1,92 @@
+// realtime.h
+//	Data structures for the real-time scheduling class.
+//
+//	A thread joins the real-time class by asking for "budget" ticks
+//	of CPU every "period" ticks (the SetRealTime system call).  Ready
+//	real-time threads always run before anything the scheduling
+//	policy would pick, earliest deadline first (EDF); the deadline of
+//	a thread is the end of its current period.
+//
+//	Admission control keeps the total utilization (the sum of
+//	budget / period) at or below 1, which is exactly the condition
+//	under which EDF meets every deadline.  In return, a thread that
+//	has used up its budget for the period waits until its next
+//	period ("throttled"), so it cannot take more than it reserved.
+//
+//	A deadline is missed if the period ends while the thread is
+//	still runnable and has not had its budget.  A thread that blocks
+//	is taken to be done for the period.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include "copyright.h"
+#include "list.h"
+#include "heap.h"
+#include "thread.h"
+
+// The following class holds the reservation of one real-time thread,
+// and what became of it.  It outlives the thread, so that the numbers
+// can still be reported at halt.
+
+class RealTimeRecord {
+  public:
+    RealTimeRecord(Thread *thread);
+
+    Thread *thread;		// the thread, NULL once it is gone
+    int id;			// the thread's ID
+    char *name;			// the thread's name
+    int period;			// reserved "budget" ticks every "period"
+    int budget;
+    int deadline;		// end of the current period
+    int used;			// CPU ticks used this period
+    int charged;		// thread's cpuTicks when last charged
+    int periods;		// periods started
+    int misses;			// deadlines missed
+};
+
+// The following class is the real-time scheduling class: the
+// admitted threads, the heap of ready ones, and the throttled ones.
+
+class RealTimeClass {
+  public:
+    RealTimeClass();
+    ~RealTimeClass();
+
+    bool IsRealTime(Thread* thread) { return thread->realTime != NULL; }
+    int Admit(Thread* thread, int period, int budget);
+    				// reserve (or, with period 0, release)
+				// CPU for thread; -1 if not admitted
+
+    void ReadyToRun(Thread* thread);	// thread can be dispatched
+    Thread* PickNext();		// dequeue the ready thread with the
+				// earliest deadline, NULL if none
+    bool OnTick(Thread* current);// should current give up the CPU?
+    void OnBlock(Thread* thread);// thread is going to sleep
+    void OnFinish(Thread* thread);// thread is done for good
+
+    void Print();		// print the ready and throttled threads
+    void PrintStats();		// print deadline misses, at halt
+
+  private:
+    List<RealTimeRecord *> *records;	// every thread ever admitted
+    Heap<Thread *> *readyList;	// earliest deadline first
+    Heap<Thread *> *throttled;	// out of budget, earliest next period
+				// first
+    double utilization;		// sum of budget / period of the
+				// admitted threads
+
+    void Charge(Thread* thread);// bill thread for its CPU time
+    void NextPeriod(RealTimeRecord *rec, int now);
+    				// start the period that contains now
+    void Release();		// end of period for ready and throttled
+				// threads whose deadline passed
+    void Withdraw(RealTimeRecord *rec);
+    				// take rec's thread out of the class
+};
+
+#endif // REALTIME_H
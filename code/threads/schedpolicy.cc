@@ -0,0 +1,494 @@
+// schedpolicy.cc
+//	The scheduling policies that can be selected with -sched:
+//	fifo, rr, priority, sjf and mlfq (the default).  The proportional
+//	share policies live in fairshare.cc.
+//
+//	These routines assume that interrupts are already disabled;
+//	they are only ever called from the Scheduler.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "schedpolicy.h"
+#include "burstpredict.h"
+#include "fairshare.h"
+#include "main.h"
+
+char *SchedPolicyNames = "fifo, rr, priority, sjf, mlfq, cfs, stride";
+
+//----------------------------------------------------------------------
+// SchedParams::SchedParams
+//	Set the scheduling parameters to their defaults.
+//----------------------------------------------------------------------
+
+SchedParams::SchedParams()
+{
+    for (int i = 0; i < 3; i++) {
+	quantum[i] = TimerTicks;
+    }
+    l2Lowest = 50;
+    l1Lowest = 100;
+    maxPriority = 149;
+    agingInterval = 1500;
+    agingStep = 10;
+    burstAlpha = 0.5;
+    burstWindow = 4;
+    groupWindow = 1000;
+    wakeBoost = 0;
+    wakeDecay = 5;
+}
+
+//----------------------------------------------------------------------
+// SchedParams::Check
+//	Make sure the parameters make sense: every level has a time
+//	slice, the bands are in order and not empty, and so on.
+//
+// Returns:
+//	TRUE if they do.
+//----------------------------------------------------------------------
+
+bool
+SchedParams::Check()
+{
+    for (int i = 0; i < 3; i++) {
+	if (quantum[i] < 1) {
+	    return FALSE;
+	}
+    }
+    return 0 < l2Lowest && l2Lowest < l1Lowest && l1Lowest <= maxPriority &&
+	agingInterval > 0 && agingStep >= 0 &&
+	burstAlpha >= 0 && burstAlpha <= 1 &&
+	burstWindow >= 1 && burstWindow <= MaxBurstWindow && groupWindow > 0 &&
+	wakeBoost >= 0 && wakeBoost <= maxPriority && wakeDecay >= 0;
+}
+
+//----------------------------------------------------------------------
+// NewSchedPolicy
+//	Create the scheduling policy named "name".
+//
+// Returns:
+//	The new policy, or NULL if "name" isn't a policy we know.
+//----------------------------------------------------------------------
+
+SchedPolicy *
+NewSchedPolicy(char* name)
+{
+    if (strcmp(name, "fifo") == 0) {
+	return new FIFOPolicy();
+    } else if (strcmp(name, "rr") == 0) {
+	return new RRPolicy();
+    } else if (strcmp(name, "priority") == 0) {
+	return new PriorityPolicy();
+    } else if (strcmp(name, "sjf") == 0) {
+	return new SJFPolicy();
+    } else if (strcmp(name, "mlfq") == 0) {
+	return new MLFQPolicy();
+    } else if (strcmp(name, "cfs") == 0) {
+	return new CFSPolicy();
+    } else if (strcmp(name, "stride") == 0) {
+	return new StridePolicy();
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// cmp1, cmp2, BurstCompare
+//	Orderings for the ready queues: cmp1 runs the thread with the
+//	shortest remaining (approximate) burst first, cmp2 the thread
+//	with the highest priority first, BurstCompare the thread with
+//	the shortest approximate burst first.
+//----------------------------------------------------------------------
+int cmp1(Thread* a, Thread* b){
+    double A = a->apprBurstTime - (double)a->CPUBurstTime;
+    double B = b->apprBurstTime - (double)b->CPUBurstTime;
+    if(A > B) return 1;
+    if(A < B) return -1;
+    return 0;
+}
+int cmp2(Thread* a, Thread* b){
+    if(a->priority > b->priority) return -1;
+    if(a->priority < b->priority) return 1;
+    return 0;
+}
+static int
+BurstCompare(Thread* a, Thread* b){
+    if(a->apprBurstTime > b->apprBurstTime) return 1;
+    if(a->apprBurstTime < b->apprBurstTime) return -1;
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// ReadyIndex
+//	Where a thread keeps its position on a ready heap, so that it
+//	can be found (and re-ordered) without searching.
+//----------------------------------------------------------------------
+int *ReadyIndex(Thread* t){
+    return &t->readyIndex;
+}
+
+//----------------------------------------------------------------------
+// FIFOPolicy::PickNext, PriorityPolicy::PickNext, SJFPolicy::PickNext
+//	Dequeue the thread at the head of the ready list, if any.
+//----------------------------------------------------------------------
+
+Thread *
+FIFOPolicy::PickNext()
+{
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    return readyList->RemoveFront();
+}
+
+Thread *
+PriorityPolicy::PickNext()
+{
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    return readyList->RemoveFront();
+}
+
+Thread *
+SJFPolicy::PickNext()
+{
+    if (readyList->IsEmpty()) {
+	return NULL;
+    }
+    return readyList->RemoveFront();
+}
+
+//----------------------------------------------------------------------
+// FIFOPolicy::Print, PriorityPolicy::Print, SJFPolicy::Print
+//	Print the contents of the ready list.  For debugging.
+//----------------------------------------------------------------------
+
+void
+FIFOPolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
+
+void
+PriorityPolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
+
+void
+SJFPolicy::Print()
+{
+    readyList->Apply(ThreadPrint);
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::PriorityPolicy
+//	Initialize an empty priority-ordered ready list.
+//----------------------------------------------------------------------
+
+PriorityPolicy::PriorityPolicy()
+{
+    readyList = new IntrusiveSortedList<Thread *>(QueueLink, cmp2);
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::OnTick
+//	Preempt the running thread if a ready thread has at least
+//	its priority -- equal priorities take turns.
+//----------------------------------------------------------------------
+
+bool
+PriorityPolicy::OnTick(Thread* current)
+{
+    return !readyList->IsEmpty() &&
+	readyList->Front()->priority >= current->priority;
+}
+
+//----------------------------------------------------------------------
+// PriorityPolicy::Reorder
+//	A ready thread's priority changed; re-sort it.
+//----------------------------------------------------------------------
+
+void
+PriorityPolicy::Reorder(Thread* thread)
+{
+    if (readyList->IsInList(thread)) {
+	readyList->Remove(thread);
+	readyList->Insert(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// SJFPolicy::SJFPolicy
+//	Initialize an empty burst-ordered ready heap.
+//----------------------------------------------------------------------
+
+SJFPolicy::SJFPolicy()
+{
+    readyList = new Heap<Thread *>(BurstCompare, ReadyIndex);
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::MLFQPolicy
+// 	Initialize the three (empty) ready queues.
+//----------------------------------------------------------------------
+
+MLFQPolicy::MLFQPolicy()
+{
+    L1 = new Heap<Thread *>(cmp1, ReadyIndex);
+    L2 = new IntrusiveSortedList<Thread *>(QueueLink, cmp2);
+    L3 = new IntrusiveList<Thread *>(QueueLink);
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::~MLFQPolicy
+// 	De-allocate the ready queues.
+//----------------------------------------------------------------------
+
+MLFQPolicy::~MLFQPolicy()
+{
+    delete L1;
+    delete L2;
+    delete L3;
+}
+
+//----------------------------------------------------------------------
+// AgeThread
+//	Credit "t" with the time it has waited since it was last aged,
+//	and raise its priority by agingStep (10) for every agingInterval
+//	(1500) ticks of waiting.  A thread running at a priority it
+//	inherited from the locks it holds ages its own priority, so that
+//	it keeps the aging when it releases them (see AddPriority).
+//----------------------------------------------------------------------
+static void
+AgeThread(Thread* t){
+    SchedParams *params = kernel->schedParams;
+    int now = kernel->stats->totalTicks;
+    t->waitingTime += now - t->lastWait;
+    t->lastWait = now;
+    int old = t->priority;
+    int own = t->basePriority >= 0 ? t->basePriority : t->priority;
+    if(t->waitingTime > params->agingInterval){
+        t->waitingTime -= params->agingInterval;
+        int step = params->agingStep;
+        if(own + step > params->maxPriority) step = params->maxPriority - own;
+        if(step > 0){
+            kernel->scheduler->AddPriority(t, step);
+            kernel->scheduler->AddTickets(t, step);
+        }
+        if(t->priority != old){
+            DEBUG(dbgMFQ, "[C] Tick ["<<
+            kernel->stats->totalTicks<<
+            "]: Thread ["<<
+            t->getID()<<
+            "] changes its priority from ["<<
+            old<<
+            "] to ["<<
+            t->priority<<
+            "]");
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Enqueue
+//	Put a thread on the ready queue for its priority band.
+//
+// Returns:
+//	The queue level (1, 2 or 3) the thread is now on.
+//----------------------------------------------------------------------
+int
+MLFQPolicy::Enqueue(Thread* t){
+    SchedParams *params = kernel->schedParams;
+    int level;
+    if(t->priority < params->l2Lowest){
+        L3->Append(t);
+        level = 3;
+    }else if(t->priority < params->l1Lowest){
+        L2->Insert(t);
+        level = 2;
+    }else{
+        L1->Insert(t);
+        level = 1;
+    }
+    t->listBelong = level;
+    return level;
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Dequeue
+//	Take a ready thread off the queue it is on.
+//----------------------------------------------------------------------
+void
+MLFQPolicy::Dequeue(Thread* t){
+    switch(t->listBelong){
+        case 1: L1->Remove(t); break;
+        case 2: L2->Remove(t); break;
+        case 3: L3->Remove(t); break;
+        default: ASSERTNOTREACHED();
+    }
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Age
+//	Age every ready thread, and move those whose priority crossed
+//	into a higher band.
+//
+//	Aging never changes a thread's remaining burst, so L1 threads
+//	keep their place on the heap and are only visited; L2 and L3
+//	are rebuilt, since priorities there decide the order (and the
+//	queue).
+//----------------------------------------------------------------------
+void
+MLFQPolicy::Age(){
+    Thread* t;
+    IntrusiveList<Thread *> temp(QueueLink);
+
+    L1->Apply(AgeThread);
+    while(!L2->IsEmpty()) temp.Append(L2->RemoveFront());
+    while(!L3->IsEmpty()) temp.Append(L3->RemoveFront());
+    while(!temp.IsEmpty()){
+        t = temp.RemoveFront();
+        AgeThread(t);
+        int old = t->listBelong;
+        if(Enqueue(t) != old){
+            DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks << "]: Thread [" << t->getID() << "] is inserted into queue L[" << t->listBelong << "]");
+        }
+    }
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Preempting
+//	Decide whether the running thread should give way.  Only looks
+//	at the queue heads, so it does not depend on how many threads
+//	are ready.
+//----------------------------------------------------------------------
+bool
+MLFQPolicy::Preempting(Thread* current){
+    Thread* t;
+    //2 cases for preempting
+    //1. there exist a thread from higher queue
+    //2. L1 thread with lower approximate CPU burst time
+    bool higherQueue = (current->listBelong > 1 && !L1->IsEmpty()) ||
+                       (current->listBelong > 2 && !L2->IsEmpty());
+    bool shorterBurst = FALSE;
+    if(!L1->IsEmpty()){
+        t = L1->Front();
+        double remain = t->apprBurstTime - (double)t->CPUBurstTime;
+        double cur_remainTime = current->apprBurstTime - (double)current->CPUBurstTime;
+        shorterBurst = remain < cur_remainTime;
+    }
+    return shorterBurst || higherQueue;
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::OnTick
+//	Age the ready threads, then preempt the running thread if a
+//	better thread is ready, or (round robin) if it is on L3.
+//----------------------------------------------------------------------
+bool
+MLFQPolicy::OnTick(Thread* current)
+{
+    Age();
+    return current->listBelong == 3 || Preempting(current);
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::ReadyToRun
+//	Put a thread on the ready queue for its priority band.
+//----------------------------------------------------------------------
+void
+MLFQPolicy::ReadyToRun(Thread* thread)
+{
+    int queueLevel = Enqueue(thread);
+    DEBUG(dbgMFQ, "[A] Tick ["<<
+    kernel->stats->totalTicks <<
+    "]: Thread ["<<thread->getID()<<
+    "] is inserted into queue L["<<queueLevel<<
+    "]");
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::PickNext
+//	Dequeue the first thread on the highest non-empty queue.
+//----------------------------------------------------------------------
+Thread *
+MLFQPolicy::PickNext()
+{
+    Thread* nextToRun = NULL;
+    int queueLevel;
+    if(!L1->IsEmpty()){
+        nextToRun = L1->RemoveFront();
+        queueLevel = 1;
+    } else if(!L2->IsEmpty()){
+        nextToRun = L2->RemoveFront();
+        queueLevel = 2;
+    } else if(!L3->IsEmpty()){
+        nextToRun = L3->RemoveFront();
+        queueLevel = 3;
+    }
+    if(nextToRun != NULL){
+        DEBUG(dbgMFQ, "[B] Tick ["<<
+        kernel->stats->totalTicks<<
+        "]: Thread ["<<
+        nextToRun->getID()<<
+        "] is removed from queue L["<<
+        queueLevel<<
+        "]");
+    }
+    return nextToRun;
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Reorder
+//	A ready thread's priority or burst estimate changed.  On L1,
+//	if it stays in the band, just move it on the heap; otherwise
+//	requeue it in the band it now belongs to.
+//----------------------------------------------------------------------
+void
+MLFQPolicy::Reorder(Thread* thread)
+{
+    if(thread->listBelong == 1 && L1->IsInList(thread) &&
+       thread->priority >= kernel->schedParams->l1Lowest){
+        L1->Update(thread);
+        return;
+    }
+    Dequeue(thread);
+    int old = thread->listBelong;
+    if(Enqueue(thread) != old){
+        DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks << "]: Thread [" << thread->getID() << "] is inserted into queue L[" << thread->listBelong << "]");
+    }
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Quantum
+//	Each level has its own time slice; a thread that never went
+//	through the queues (main) gets the default.
+//----------------------------------------------------------------------
+int
+MLFQPolicy::Quantum(Thread* thread)
+{
+    if(thread->listBelong < 1 || thread->listBelong > 3){
+        return TimerTicks;
+    }
+    return kernel->schedParams->quantum[thread->listBelong - 1];
+}
+
+//----------------------------------------------------------------------
+// MLFQPolicy::Print
+//	Print the contents of the three ready queues.  For debugging.
+//----------------------------------------------------------------------
+void
+MLFQPolicy::Print()
+{
+    cout << "L1: ";
+    L1->Apply(ThreadPrint);
+    cout << "\nL2: ";
+    L2->Apply(ThreadPrint);
+    cout << "\nL3: ";
+    L3->Apply(ThreadPrint);
+    cout << "\n";
+}
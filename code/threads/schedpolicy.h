@@ -0,0 +1,209 @@
+// schedpolicy.h
+//	Data structures for the scheduling policies -- the part of the
+//	scheduler that decides *which* ready thread runs next, and
+//	*when* the running thread should be preempted.
+//
+//	The Scheduler itself only does the mechanism (keeping track of
+//	the thread to destroy, context switching); it hands every policy
+//	decision to a SchedPolicy object, chosen at boot time with the
+//	-sched flag, so that different policies can be compared on the
+//	same workload without rebuilding Nachos.
+//
+//	A policy sees these events ("hooks"):
+//
+//	ReadyToRun -- a thread is ready; put it on the ready queue
+//	PickNext -- remove and return the next thread to run
+//	OnTick -- the timer went off while "current" was running;
+//		should it give up the CPU?
+//	OnBlock -- the running thread is about to block
+//	OnFinish -- the running thread is about to finish
+//	OnWake -- a blocked thread was woken up (followed by ReadyToRun)
+//	Reorder -- the ordering key (priority, burst estimate) of a
+//		ready thread changed; move it to its new place
+//	PrintStats -- Nachos is halting; report on how the policy did
+//
+//	A policy also says how long a time slice ("Quantum") the thread
+//	it picked gets; the timer is re-armed for that long whenever a
+//	thread is dispatched.
+//
+//	All hooks are called with interrupts disabled.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SCHEDPOLICY_H
+#define SCHEDPOLICY_H
+
+#include "copyright.h"
+#include "list.h"
+#include "intrusivelist.h"
+#include "heap.h"
+#include "thread.h"
+#include "stats.h"
+
+// The following class holds the scheduling parameters that can be
+// changed from the command line (see Kernel::Kernel), so that the
+// multilevel feedback queue can be tuned without recompiling.
+
+class SchedParams {
+  public:
+    SchedParams();		// the defaults
+    bool Check();		// are the parameters consistent?
+
+    int quantum[3];		// time slice on L1, L2 and L3 (-quantum)
+    int l2Lowest;		// lowest priority on L2; below is L3
+    int l1Lowest;		// lowest priority on L1 (-bands)
+    int maxPriority;		// highest priority there is
+    int agingInterval;		// ticks of waiting that earn...
+    int agingStep;		// ...this much more priority (-aging)
+    double burstAlpha;		// weight of the latest CPU burst in the
+				// approximate burst time (-alpha)
+    int burstWindow;		// bursts the window and median
+				// predictors look back on (-window)
+    int groupWindow;		// ticks over which process group
+				// shares and quotas apply (-gwindow)
+    int wakeBoost;		// priority added to a thread woken by
+				// an interrupt (I/O done), 0 for none
+    int wakeDecay;		// priority the boost loses per timer
+				// tick the thread runs (-wakeboost)
+};
+
+// The following class defines the interface every scheduling
+// policy implements.
+
+class SchedPolicy {
+  public:
+    virtual ~SchedPolicy() {}
+
+    virtual char* getName() = 0;	// name used with -sched
+
+    virtual void ReadyToRun(Thread* thread) = 0;
+    				// thread can be dispatched
+    virtual Thread* PickNext() = 0;	// dequeue the next thread to run,
+    				// NULL if there is none
+    virtual bool OnTick(Thread* current) = 0;
+    				// TRUE if current should yield the CPU
+    virtual void OnBlock(Thread* thread) {}
+    				// thread is going to sleep
+    virtual void OnFinish(Thread* thread) {}
+    				// thread is done for good
+    virtual void OnWake(Thread* thread) {}
+    				// thread woke up, and is about to be
+				// passed to ReadyToRun
+    virtual void Reorder(Thread* thread) {}
+    				// a ready thread's key changed
+    virtual int Quantum(Thread* thread) { return TimerTicks; }
+    				// length of the time slice thread gets
+    virtual void Print() = 0;	// print the ready queue(s)
+    virtual void PrintStats() {}	// print statistics at halt
+};
+
+// Return a new policy given its -sched name, or NULL if there is
+// no such policy.  "SchedPolicyNames" lists the valid names.
+extern SchedPolicy *NewSchedPolicy(char* name);
+extern char *SchedPolicyNames;
+
+// Where a thread keeps its position on a ready Heap.
+extern int *ReadyIndex(Thread* t);
+
+// First come, first served.  Never preempts: a thread runs until
+// it blocks or finishes.
+
+class FIFOPolicy : public SchedPolicy {
+  public:
+    FIFOPolicy() { readyList = new IntrusiveList<Thread *>(QueueLink); }
+    ~FIFOPolicy() { delete readyList; }
+
+    char* getName() { return "fifo"; }
+    void ReadyToRun(Thread* thread) { readyList->Append(thread); }
+    Thread* PickNext();
+    bool OnTick(Thread* current) { return FALSE; }
+    void Print();
+
+  protected:
+    IntrusiveList<Thread *> *readyList;	// threads in arrival order
+};
+
+// Round robin: FIFO, but the running thread goes to the back of
+// the queue on every timer tick if anyone else is waiting.
+
+class RRPolicy : public FIFOPolicy {
+  public:
+    char* getName() { return "rr"; }
+    bool OnTick(Thread* current) { return !readyList->IsEmpty(); }
+};
+
+// Preemptive priority: run the highest "priority" first, round
+// robin among threads of equal priority.
+
+class PriorityPolicy : public SchedPolicy {
+  public:
+    PriorityPolicy();
+    ~PriorityPolicy() { delete readyList; }
+
+    char* getName() { return "priority"; }
+    void ReadyToRun(Thread* thread) { readyList->Insert(thread); }
+    Thread* PickNext();
+    bool OnTick(Thread* current);
+    void Reorder(Thread* thread);
+    void Print();
+
+  private:
+    IntrusiveSortedList<Thread *> *readyList;	// highest priority first
+};
+
+// Non-preemptive shortest job first, by approximate CPU burst.
+
+class SJFPolicy : public SchedPolicy {
+  public:
+    SJFPolicy();
+    ~SJFPolicy() { delete readyList; }
+
+    char* getName() { return "sjf"; }
+    void ReadyToRun(Thread* thread) { readyList->Insert(thread); }
+    Thread* PickNext();
+    bool OnTick(Thread* current) { return FALSE; }
+    void Reorder(Thread* thread) { readyList->Update(thread); }
+    void Print();
+
+  private:
+    Heap<Thread *> *readyList;	// shortest approximate burst first
+};
+
+// The multilevel feedback queue (the default):
+//	L1 (priority 100-149) -- preemptive shortest remaining burst first
+//	L2 (priority 50-99) -- non-preemptive, highest priority first
+//	L3 (priority 0-49) -- round robin
+// Threads that wait 1500 ticks have their priority raised by 10.
+// All of these numbers, and the time slice on each level, are
+// defaults; see SchedParams.
+
+class MLFQPolicy : public SchedPolicy {
+  public:
+    MLFQPolicy();
+    ~MLFQPolicy();
+
+    char* getName() { return "mlfq"; }
+    void ReadyToRun(Thread* thread);
+    Thread* PickNext();
+    bool OnTick(Thread* current);
+    void Reorder(Thread* thread);
+    int Quantum(Thread* thread);
+    void Print();
+
+  private:
+    Heap<Thread *> *L1;		// shortest remaining burst first
+    IntrusiveSortedList<Thread *> *L2;	// highest priority first
+    IntrusiveList<Thread *> *L3;	// round robin
+
+    int Enqueue(Thread* thread);// put thread on the queue for its
+    				// priority band, return the level
+    void Dequeue(Thread* thread);
+    				// take thread off whichever queue it is on
+    void Age();			// age every ready thread
+    bool Preempting(Thread* current);
+    				// should current give way to a ready thread?
+};
+
+#endif // SCHEDPOLICY_H
@@ -0,0 +1,327 @@
+// schedtrace.cc
+//	Routines to record scheduling traces, and to replay them.
+//	See schedtrace.h for the trace format.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "schedtrace.h"
+#include "synch.h"
+#include "main.h"
+
+const int TraceNameSize = 64;		// longest thread name we read,
+					// including the '\0'
+
+//----------------------------------------------------------------------
+// TraceEntry::TraceEntry
+//	Start the trace of a thread, with no bursts yet.  The name is
+//	copied, since the entry may outlive the thread.
+//----------------------------------------------------------------------
+
+TraceEntry::TraceEntry(char *threadName, int arrivalTime, int threadPriority)
+{
+    name = new char[strlen(threadName) + 1];
+    strcpy(name, threadName);
+    arrival = arrivalTime;
+    priority = threadPriority;
+    events = new List<int>;
+    lastCpuTicks = 0;
+    blockedAt = 0;
+}
+
+//----------------------------------------------------------------------
+// TraceEntry::~TraceEntry
+//	De-allocate the trace of a thread.
+//----------------------------------------------------------------------
+
+TraceEntry::~TraceEntry()
+{
+    delete [] name;
+    delete events;
+}
+
+//----------------------------------------------------------------------
+// TraceEntry::Write
+//	Append the trace of this thread to "file".
+//----------------------------------------------------------------------
+
+void
+TraceEntry::Write(FILE *file)
+{
+    ListIterator<int> iter(events);
+
+    fprintf(file, "T %d %d %s\n", arrival, priority, name);
+    for (; !iter.IsDone(); iter.Next()) {
+	if (iter.Item() >= 0) {
+	    fprintf(file, "C %d\n", iter.Item());
+	} else {
+	    fprintf(file, "I %d\n", -iter.Item());
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::TraceRecorder
+//	Open "fileName" to record a trace into.
+//----------------------------------------------------------------------
+
+TraceRecorder::TraceRecorder(char *fileName)
+{
+    file = fopen(fileName, "w");
+    if (file == NULL) {
+	cerr << "Can't create trace file " << fileName << "\n";
+	Exit(1);
+    }
+    fprintf(file, "# T <arrival> <priority> <name>, then C <burst> / "
+		  "I <wait> ticks\n");
+    unfinished = new List<TraceEntry *>;
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::~TraceRecorder
+//	Write out the threads that were still around when Nachos
+//	halted, and close the trace file.
+//----------------------------------------------------------------------
+
+TraceRecorder::~TraceRecorder()
+{
+    TraceEntry *entry;
+
+    while (!unfinished->IsEmpty()) {
+	entry = unfinished->RemoveFront();
+	entry->Write(file);
+	delete entry;
+    }
+    delete unfinished;
+    fclose(file);
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::Arrived
+//	"thread" was forked; start its trace.
+//----------------------------------------------------------------------
+
+void
+TraceRecorder::Arrived(Thread* thread)
+{
+    TraceEntry *entry = new TraceEntry(thread->getName(),
+			kernel->stats->totalTicks, thread->priority);
+
+    entry->lastCpuTicks = thread->cpuTicks;
+    thread->trace = entry;
+    unfinished->Append(entry);
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::EndBurst
+//	The running "thread" is giving up the CPU for good or to wait;
+//	record the CPU burst it just finished.
+//----------------------------------------------------------------------
+
+void
+TraceRecorder::EndBurst(Thread* thread)
+{
+    TraceEntry *entry = thread->trace;
+
+    entry->events->Append(thread->cpuTicks - entry->lastCpuTicks);
+    entry->lastCpuTicks = thread->cpuTicks;
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::Blocked, TraceRecorder::Woke
+//	"thread" went to sleep, or woke up.  The time in between is
+//	recorded as I/O.
+//----------------------------------------------------------------------
+
+void
+TraceRecorder::Blocked(Thread* thread)
+{
+    EndBurst(thread);
+    thread->trace->blockedAt = kernel->stats->totalTicks;
+}
+
+void
+TraceRecorder::Woke(Thread* thread)
+{
+    TraceEntry *entry = thread->trace;
+
+    entry->events->Append(-(kernel->stats->totalTicks - entry->blockedAt));
+}
+
+//----------------------------------------------------------------------
+// TraceRecorder::Finished
+//	"thread" is done; write out its trace.
+//----------------------------------------------------------------------
+
+void
+TraceRecorder::Finished(Thread* thread)
+{
+    TraceEntry *entry = thread->trace;
+
+    EndBurst(thread);
+    entry->Write(file);
+    unfinished->Remove(entry);
+    delete entry;
+    thread->trace = NULL;
+}
+
+//----------------------------------------------------------------------
+// TraceThreadBody
+//	Dummy function because C++ does not (easily) allow pointers to
+//	member functions.
+//----------------------------------------------------------------------
+
+static void
+TraceThreadBody(TraceThread *t)
+{
+    t->Run();
+}
+
+//----------------------------------------------------------------------
+// TraceThread::TraceThread
+//	Get ready to replay "traceEntry" with a thread called "threadID".
+//	"whenDone" is V'ed when the replay is over.
+//----------------------------------------------------------------------
+
+TraceThread::TraceThread(TraceEntry *traceEntry, int threadID,
+			 Semaphore *whenDone)
+{
+    entry = traceEntry;
+    id = threadID;
+    thread = NULL;
+    ioDone = new Semaphore("trace I/O", 0);
+    done = whenDone;
+}
+
+//----------------------------------------------------------------------
+// TraceThread::~TraceThread
+//	De-allocate the replay of a thread.
+//----------------------------------------------------------------------
+
+TraceThread::~TraceThread()
+{
+    delete ioDone;
+    delete entry;
+}
+
+//----------------------------------------------------------------------
+// TraceThread::CallBack
+//	Interrupt handler.  The first interrupt is the thread arriving:
+//	fork it.  After that, each is the end of an I/O wait.
+//----------------------------------------------------------------------
+
+void
+TraceThread::CallBack()
+{
+    if (thread == NULL) {
+	thread = new Thread(entry->name, id);
+	thread->setPriority(entry->priority);
+	thread->setStackSize(SmallStackSize);	// only burns CPU and waits
+	thread->Fork((VoidFunctionPtr) TraceThreadBody, (void *) this);
+    } else {
+	ioDone->V();
+    }
+}
+
+//----------------------------------------------------------------------
+// TraceThread::Run
+//	Replay the thread: use up each CPU burst, and wait out each I/O
+//	(as a simulated device interrupt).
+//----------------------------------------------------------------------
+
+void
+TraceThread::Run()
+{
+    ListIterator<int> iter(entry->events);
+    int ticks;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	ticks = iter.Item();
+	if (ticks > 0) {
+	    kernel->interrupt->RunFor(ticks);
+	} else if (ticks < 0) {
+	    kernel->interrupt->Schedule(this, -ticks, DiskInt);
+	    ioDone->P();
+	}
+    }
+    done->V();
+}
+
+//----------------------------------------------------------------------
+// ReadTrace
+//	Read the trace in "fileName".
+//
+// Returns:
+//	The list of threads in the trace.
+//----------------------------------------------------------------------
+
+static List<TraceEntry *> *
+ReadTrace(char *fileName)
+{
+    List<TraceEntry *> *entries = new List<TraceEntry *>;
+    TraceEntry *entry = NULL;
+    FILE *file = fopen(fileName, "r");
+    char name[TraceNameSize];
+    int arrival, priority, ticks, c;
+    char kind;
+
+    if (file == NULL) {
+	cerr << "Can't open trace file " << fileName << "\n";
+	Exit(1);
+    }
+    while (fscanf(file, " %c", &kind) == 1) {
+	if (kind == '#') {			// skip the rest of the line
+	    while ((c = getc(file)) != '\n' && c != EOF) ;
+	} else if (kind == 'T' &&
+		   fscanf(file, "%d %d %63s", &arrival, &priority, name) == 3) {
+	    entry = new TraceEntry(name, arrival, priority);
+	    entries->Append(entry);
+	} else if ((kind == 'C' || kind == 'I') && entry != NULL &&
+		   fscanf(file, "%d", &ticks) == 1 && ticks >= 0) {
+	    entry->events->Append(kind == 'C' ? ticks : -ticks);
+	} else {
+	    cerr << "Bad trace file " << fileName << " at '" << kind << "'\n";
+	    Exit(1);
+	}
+    }
+    fclose(file);
+    return entries;
+}
+
+//----------------------------------------------------------------------
+// ReplayTrace
+//	Replay the trace in "fileName" through the scheduler: every
+//	thread arrives at its (recorded) arrival time, counted from now,
+//	and then uses up its bursts and waits out its I/O.  When every
+//	thread is done, halt, printing the statistics.
+//----------------------------------------------------------------------
+
+void
+ReplayTrace(char *fileName)
+{
+    List<TraceEntry *> *entries = ReadTrace(fileName);
+    Semaphore *done = new Semaphore("trace done", 0);
+    TraceThread *t;
+    int n = 0;
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+
+    while (!entries->IsEmpty()) {
+	t = new TraceThread(entries->RemoveFront(), ++n, done);
+	if (t->Arrival() > 0) {
+	    kernel->interrupt->Schedule(t, t->Arrival(), DiskInt);
+	} else {
+	    t->CallBack();		// arrives right away
+	}
+    }
+    delete entries;
+    (void) kernel->interrupt->SetLevel(oldLevel);
+
+    for (int i = 0; i < n; i++) {
+	done->P();
+    }
+    cout << "Replayed " << n << " threads from " << fileName << "\n";
+    kernel->interrupt->Halt();
+}
@@ -0,0 +1,106 @@
+// schedtrace.h
+//	Data structures to record the CPU bursts and I/O waits of the
+//	threads Nachos runs, and to replay them later -- through the same
+//	Scheduler, and the same simulated clock -- without running any
+//	MIPS code.
+//
+//	"nachos -record <file> ..." writes a trace of every forked thread
+//	as it finishes; "nachos -replay <file>" forks a kernel thread for
+//	every thread in the trace, which just uses up the recorded CPU
+//	bursts (Interrupt::RunFor) and waits out the recorded I/O, so a
+//	scheduling policy can be tried on a workload in a fraction of
+//	the time it takes to run the real thing.
+//
+//	A trace is a text file.  Each thread starts with a "T" line,
+//	followed by its CPU bursts ("C") and the time it was blocked
+//	after each ("I"), in order:
+//
+//		# comment
+//		T <arrival tick> <priority> <name>
+//		C <ticks>
+//		I <ticks>
+//		C <ticks>
+//		...
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef SCHEDTRACE_H
+#define SCHEDTRACE_H
+
+#include "copyright.h"
+#include "list.h"
+#include "callback.h"
+#include "thread.h"
+
+class Semaphore;
+
+// The following class is the trace of one thread: when it arrived,
+// at what priority, and its CPU bursts and I/O waits.  Bursts are
+// stored as positive numbers of ticks, I/O waits as negative ones.
+
+class TraceEntry {
+  public:
+    TraceEntry(char *threadName, int arrivalTime, int threadPriority);
+    ~TraceEntry();
+
+    char *name;			// the thread's name
+    int arrival;		// when it was first made ready
+    int priority;		// its priority then
+    List<int> *events;		// bursts (> 0) and I/O waits (< 0)
+
+    int lastCpuTicks;		// thread's cpuTicks at the end of the
+				// last burst (recording only)
+    int blockedAt;		// when the thread last blocked
+				// (recording only)
+
+    void Write(FILE *file);	// append the entry to a trace file
+};
+
+// The following class records a trace of the threads Nachos runs.
+// The Scheduler tells it when a thread arrives, blocks, wakes up
+// and finishes.
+
+class TraceRecorder {
+  public:
+    TraceRecorder(char *fileName);	// record into "fileName"
+    ~TraceRecorder();		// write out the threads that never
+				// finished, and close the file
+
+    void Arrived(Thread* thread);	// thread forked
+    void Blocked(Thread* thread);	// thread went to sleep
+    void Woke(Thread* thread);		// thread woke up
+    void Finished(Thread* thread);	// thread is done
+
+  private:
+    FILE *file;			// the trace file
+    List<TraceEntry *> *unfinished;	// threads still running
+    void EndBurst(Thread* thread);	// record the burst that just ended
+};
+
+// The following class replays one thread of a trace.  It is also
+// the interrupt handler for the thread's (simulated) arrival and I/O.
+
+class TraceThread : public CallBackObj {
+  public:
+    TraceThread(TraceEntry *traceEntry, int threadID, Semaphore *whenDone);
+    ~TraceThread();
+
+    int Arrival() { return entry->arrival; }
+    				// when the thread arrives
+    void CallBack();		// arrival, or I/O completion
+    void Run();			// replay the bursts and waits
+
+  private:
+    TraceEntry *entry;		// what to replay
+    int id;			// ID of the thread replaying it
+    Thread *thread;		// the thread, once it has arrived
+    Semaphore *ioDone;		// V'ed when a (simulated) I/O is done
+    Semaphore *done;		// V'ed when the thread is done
+};
+
+// Replay the trace in "fileName", then halt.
+extern void ReplayTrace(char *fileName);
+
+#endif // SCHEDTRACE_H
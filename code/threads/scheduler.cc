@@ -11,8 +11,8 @@
 //	end up calling FindNextToRun(), and that would put us in an 
 //	infinite loop.
 //
-// 	Very simple implementation -- no priorities, straight FIFO.
-//	Might need to be improved in later assignments.
+// 	The choice of the next thread is delegated to a scheduling
+//	policy (see schedpolicy.h), selected at boot time with -sched.
 //
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
@@ -27,27 +27,21 @@
 // Scheduler::Scheduler
 // 	Initialize the list of ready but not running threads.
 //	Initially, no ready threads.
+//
+//	"schedPolicy" is the policy that orders the ready threads.
+//	CPU bursts are predicted by EWMA, unless SetPredictor says
+//	otherwise.
 //----------------------------------------------------------------------
-int cmp1(Thread* a, Thread* b){
-    double A = a->apprBurstTime - (double)a->CPUBurstTime;
-    double B = b->apprBurstTime - (double)b->CPUBurstTime;
-    if(A > B) return 1;
-    if(A < B) return -1;
-    return 0;
-}
-int cmp2(Thread* a, Thread* b){
-    if(a->priority > b->priority) return -1;
-    if(a->priority < b->priority) return 1;
-    return 0;
-}
-Scheduler::Scheduler()
+
+Scheduler::Scheduler(SchedPolicy *schedPolicy)
 { 
-    //readyList = new List<Thread *>; 
-    L1 = new SortedList<Thread *>(cmp1);
-    L2 = new SortedList<Thread *>(cmp2);
-    L3 = new List<Thread *>;
-    preempting = 0;
+    policy = schedPolicy;
+    realTime = new RealTimeClass();
     toBeDestroyed = NULL;
+    userStateOwner = NULL;
+    recorder = NULL;
+    predictor = new EWMAPredictor();
+    groups = new GroupScheduler();
 } 
 
 //----------------------------------------------------------------------
@@ -57,10 +51,11 @@ Scheduler::Scheduler()
 
 Scheduler::~Scheduler()
 { 
-    //delete readyList;
-    delete L1;
-    delete L2;
-    delete L3; 
+    delete policy;
+    delete realTime;
+    delete recorder;		// writes out the rest of the trace
+    delete predictor;
+    delete groups;
 } 
 
 //----------------------------------------------------------------------
@@ -70,121 +65,63 @@ Scheduler::~Scheduler()
 //
 //	"thread" is the thread to be put on the ready list.
 //----------------------------------------------------------------------
-void 
-Scheduler::age_util(List<Thread*>*li, ListIterator<Thread *>* it, List<Thread *> *temp){
-    int now = kernel->stats->totalTicks;
-    Thread* t;
-    for(;!it->IsDone();it->Next()){
-        t = it->Item();
-        temp->Append(t);
-        li->RemoveFront();
-        if(li->IsEmpty()) break;
-    }
-}
 
-void 
-Scheduler::age(){
-    ListIterator<Thread *>* it = new ListIterator<Thread *>(L1);
-    List<Thread *> *temp = new List<Thread *>;
-    age_util(L1, it, temp);
-    it = new ListIterator<Thread *>(L2);
-    age_util(L2, it, temp);
-    it = new ListIterator<Thread *>(L3);
-    age_util(L3, it, temp);
-    it = new ListIterator<Thread *>(temp);
-    Thread* t;
-    double BurstTime_min = 1e18;
-    int now = kernel->stats->totalTicks;
-    bool higherQueue = 0;
-    //cout << "HELLO0\n";
-    for(;!it->IsDone();it->Next()){
-        t = it->Item();
-        //age
-        t->waitingTime += now - t->lastWait;
-        t->lastWait = now;
-        int old = t->priority;
-        if(t->waitingTime > 1500){
-            t->waitingTime -= 1500;
-            t->priority += 10;
-            if(t->priority >= 149) t->priority = 149;
-            if(t->priority != old){
-                DEBUG(dbgMFQ, "[C] Tick ["<<
-                kernel->stats->totalTicks<<
-                "]: Thread ["<<
-                t->getID()<<
-                "] changes its priority from ["<<
-                old<<
-                "] to ["<<
-                t->priority<<
-                "]");
-            }
-        }
-        //put into ready queue
-        if(t->priority >= 0 && t->priority <= 49){
-            L3->Append(t);
-            if(t->listBelong != 3){
-                DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks << "]: Thread [" << t->getID() << "] is inserted into queue L[" << t->listBelong << "]");
-                t->listBelong = 3;
-            }
-        }else if(t->priority <= 99){
-            L2->Insert(t);
-            if(t->listBelong != 2){
-                DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks << "]: Thread [" << t->getID() << "] is inserted into queue L[" << t->listBelong << "]");
-                t->listBelong = 2;
-            }
-        }else if(t->priority <= 149){
-            L1->Insert(t);
-            if(t->listBelong != 1){
-                t->listBelong = 1;
-                DEBUG(dbgMFQ, "[A] Tick [" << kernel->stats->totalTicks << "]: Thread [" << t->getID() << "] is inserted into queue L[" << t->listBelong << "]");
-            }
-            double remain = t->apprBurstTime - (double)t->CPUBurstTime;
-            BurstTime_min = min(BurstTime_min, remain);
-        }
-        //cout << "HELLO1\n";
-        higherQueue |= t->listBelong < kernel->currentThread->listBelong;
-    }
-    delete temp;
-    //3 cases for preempting
-    //1. there exist a thread from higher queue
-    //2. L1 thread with lower approximate CPU burst time
-    //3. round robin for L3 queue
-    double cur_remainTime = kernel->currentThread->apprBurstTime - (double)t->CPUBurstTime;
-    preempting = (BurstTime_min < cur_remainTime) || higherQueue;
-}
 void
 Scheduler::ReadyToRun (Thread *thread)
 {
     ASSERT(kernel->interrupt->getLevel() == IntOff);
     DEBUG(dbgThread, "Putting thread on ready list: " << thread->getName());
-	//cout << "Putting thread on ready list: " << thread->getName() << endl ;
+
+    if (thread->times == NULL) {
+	StartTimes(thread);
+    }
+    if (thread->getStatus() == JUST_CREATED) {	// forked into the group
+	if (thread->group == NULL &&		// of its parent, if any
+	    !kernel->interrupt->InHandler()) {
+	    thread->group = kernel->currentThread->group;
+	}
+	if (thread->group != NULL) {
+	    groups->Join(thread);
+	}
+    }
+    thread->times->readySince = kernel->stats->totalTicks;
+    if (recorder != NULL) {
+	if (thread->getStatus() == JUST_CREATED) {
+	    recorder->Arrived(thread);
+	} else if (thread->getStatus() == BLOCKED && thread->trace != NULL) {
+	    recorder->Woke(thread);
+	}
+    }
+
+    if (realTime->IsRealTime(thread)) {
+	thread->setStatus(READY);
+	realTime->ReadyToRun(thread);
+	return;
+    }
+    if (thread->getStatus() == BLOCKED) {
+	if (kernel->interrupt->InHandler()) {	// woken by I/O (or the alarm)
+	    BoostOnWake(thread);
+	}
+	policy->OnWake(thread);
+    }
     thread->setStatus(READY);
-    // readyList->Append(thread);
-    int queueLevel = -1;
-    if(thread->priority >= 0 && thread->priority <= 49){
-        L3->Append(thread);
-        thread->listBelong = 3;
-        queueLevel = 3;
-    }else if(thread->priority <= 99){
-        L2->Insert(thread);
-        thread->listBelong = 2;
-        queueLevel = 2;
-    }else if(thread->priority <= 149){
-        L1->Insert(thread);
-        thread->listBelong = 1;
-        queueLevel = 1;
-    }
-    DEBUG(dbgMFQ, "[A] Tick ["<< 
-    kernel->stats->totalTicks <<
-    "]: Thread ["<<thread->getID()<<
-    "] is inserted into queue L["<<queueLevel<<
-    "]");
+    if (thread->group != NULL && groups->Throttle(thread)) {
+	return;				// held back for now
+    }
+    policy->ReadyToRun(thread);
 }
 
 //----------------------------------------------------------------------
 // Scheduler::FindNextToRun
-// 	Return the next thread to be scheduled onto the CPU.
+// 	Return the next thread to be scheduled onto the CPU: a ready
+//	real-time thread if there is one, else whoever the policy picks.
 //	If there are no ready threads, return NULL.
+//
+//	Held-back threads of process groups that may run again go back
+//	to the policy first; a thread the policy picks whose group may
+//	not run is held back, and the policy asked again.  If the policy
+//	has nothing, threads held back only for being over their share
+//	get the idle CPU.
 // Side effect:
 //	Thread is removed from the ready list.
 //----------------------------------------------------------------------
@@ -192,35 +129,290 @@ Scheduler::ReadyToRun (Thread *thread)
 Thread *
 Scheduler::FindNextToRun ()
 {
+    Thread *thread;
+
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    thread = realTime->PickNext();
+    if (thread != NULL) {
+	return thread;
+    }
+    while ((thread = groups->Release(FALSE)) != NULL) {
+	policy->ReadyToRun(thread);
+    }
+    for (;;) {
+	thread = policy->PickNext();
+	if (thread == NULL) {
+	    thread = groups->Release(TRUE);
+	    if (thread == NULL) {
+		return NULL;
+	    }
+	    policy->ReadyToRun(thread);
+	} else if (thread->group == NULL || groups->Picked(thread)) {
+	    return thread;
+	}
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::ShouldYield
+// 	Called on a timer tick (from Thread::Yield): ask the policy
+//	whether the running thread should give up the CPU.  Real-time
+//	threads preempt everybody else.
+//----------------------------------------------------------------------
+
+bool
+Scheduler::ShouldYield(Thread *current)
+{
+    bool yield;
+
     ASSERT(kernel->interrupt->getLevel() == IntOff);
-    Thread* nextToRun = NULL;
-    int ID, queueLevel;
-    if(!L1->IsEmpty()){
-        nextToRun = L1->RemoveFront();
-        queueLevel = 1;
-    } else if(!L2->IsEmpty()){
-        nextToRun = L2->RemoveFront();
-        queueLevel = 2;
-    } else if(!L3->IsEmpty()){
-        nextToRun = L3->RemoveFront();
-        queueLevel = 3;
-    }
-    if(nextToRun != NULL){
-        ID = nextToRun->getID();
-        DEBUG(dbgMFQ, "[B] Tick ["<<
-        kernel->stats->totalTicks<<
-        "]: Thread ["<<
-        ID<<
-        "] is removed from queue L["<<
-        queueLevel<<
-        "]");
-    }
-    return nextToRun;
-    // if (readyList->IsEmpty()) {
-	// 	return NULL;
-    // } else {
-    // 	return readyList->RemoveFront();
-    // }
+    if (realTime->IsRealTime(current)) {
+	return realTime->OnTick(current);
+    }
+    yield = policy->OnTick(current);
+    if (current->group != NULL && groups->OverLimit(current)) {
+	yield = TRUE;
+    }
+    return realTime->OnTick(current) || yield;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Blocked
+// 	The running thread is about to block (not finish); let the
+//	policy know.
+//----------------------------------------------------------------------
+
+void
+Scheduler::Blocked(Thread *thread)
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    if (recorder != NULL && thread->trace != NULL) {
+	recorder->Blocked(thread);
+    }
+    if (realTime->IsRealTime(thread)) {
+	realTime->OnBlock(thread);
+    } else {
+	policy->OnBlock(thread);
+    }
+    if (thread->group != NULL) {
+	groups->OnBlock(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Finished
+// 	The running thread is about to finish; let the policy know.
+//----------------------------------------------------------------------
+
+void
+Scheduler::Finished(Thread *thread)
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    if (recorder != NULL && thread->trace != NULL) {
+	recorder->Finished(thread);
+    }
+    if (realTime->IsRealTime(thread)) {
+	realTime->OnFinish(thread);
+    } else {
+	policy->OnFinish(thread);
+    }
+    if (thread->group != NULL) {
+	groups->OnFinish(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::Reorder
+// 	The priority or burst estimate of "thread" changed.  If it is
+//	waiting on the policy's ready list, let the policy move it.
+//	(Real-time threads are ordered by deadline, which doesn't
+//	depend on either; held-back threads are not on the list, and
+//	are put in their place when they go back.)
+//----------------------------------------------------------------------
+
+void
+Scheduler::Reorder(Thread *thread)
+{
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    if (thread->getStatus() == READY && !realTime->IsRealTime(thread) &&
+	!groups->IsThrottled(thread)) {
+	policy->Reorder(thread);
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::SetRealTime
+// 	Reserve "budget" ticks of CPU every "period" ticks for the
+//	running "thread", or (period 0) cancel its reservation.  A thread
+//	that becomes real-time leaves the policy, as if it had blocked.
+//
+// Returns:
+//	0 on success, -1 if the reservation could not be admitted.
+//----------------------------------------------------------------------
+
+int
+Scheduler::SetRealTime(Thread *thread, int period, int budget)
+{
+    bool wasRealTime = realTime->IsRealTime(thread);
+    int result;
+
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    ASSERT(thread == kernel->currentThread);
+    thread->AccumulateBurstTime(kernel->stats->totalTicks);
+    result = realTime->Admit(thread, period, budget);
+    if (!wasRealTime && realTime->IsRealTime(thread)) {
+	policy->OnBlock(thread);
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::OverQuota
+// 	Return TRUE if the process group of "thread" has used up its
+//	CPU quota for now, so that it may not run even if nobody else
+//	wants the CPU.  Real-time threads have reservations instead.
+//----------------------------------------------------------------------
+
+bool
+Scheduler::OverQuota(Thread *thread)
+{
+    return !realTime->IsRealTime(thread) && groups->OverQuota(thread);
+}
+
+//----------------------------------------------------------------------
+// Scheduler::AddPriority
+// 	Add "amount" (which may be negative) to the priority of "thread".
+//	If the thread is running at a priority inherited from the locks
+//	it holds, it is its own priority that changes; it runs at the
+//	higher of the two.
+//----------------------------------------------------------------------
+
+void
+Scheduler::AddPriority(Thread *thread, int amount)
+{
+    if (thread->basePriority >= 0) {
+	thread->basePriority += amount;
+	if (thread->basePriority > thread->priority) {
+	    thread->priority = thread->basePriority;
+	}
+    } else {
+	thread->priority += amount;
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::AddTickets
+// 	Add "amount" (which may be negative) to the stride scheduling
+//	tickets of "thread", keeping them between 1 and MaxTickets.
+//	Priority changes are passed on to the tickets this way, as they
+//	are seeded from the priority (see Thread::setPriority); the
+//	stride policy rescales the thread's pass the next time it is
+//	charged or made ready.
+//
+// Returns:
+//	How many tickets were actually added, after clamping.
+//----------------------------------------------------------------------
+
+int
+Scheduler::AddTickets(Thread *thread, int amount)
+{
+    int old = thread->tickets;
+
+    thread->tickets += amount;
+    if (thread->tickets < 1) {
+	thread->tickets = 1;
+    } else if (thread->tickets > MaxTickets) {
+	thread->tickets = MaxTickets;
+    }
+    return thread->tickets - old;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::BoostOnWake
+// 	"thread" was woken up by an interrupt handler -- its I/O is done,
+//	or its alarm went off.  Threads like that are interactive, so
+//	raise its priority by wakeBoost (-wakeboost), for it to get the
+//	CPU soon; the boost wears off as the thread runs (DecayBoost).
+//	Boosts don't stack beyond wakeBoost, or past the top priority.
+//
+//	The tickets get the same boost, as far as MaxTickets allows;
+//	ticketBoost remembers how many they got, so that exactly that
+//	many are taken back.
+//----------------------------------------------------------------------
+
+void
+Scheduler::BoostOnWake(Thread *thread)
+{
+    SchedParams *params = kernel->schedParams;
+    int amount = params->wakeBoost - thread->wakeBoost;
+    int own = thread->basePriority >= 0 ? thread->basePriority
+					: thread->priority;
+
+    if (own + amount > params->maxPriority) {
+	amount = params->maxPriority - own;
+    }
+    if (amount <= 0 || realTime->IsRealTime(thread)) {
+	return;
+    }
+    DEBUG(dbgThread, "Wake boost of " << amount << " for "
+	  << thread->getName());
+    AddPriority(thread, amount);
+    thread->wakeBoost += amount;
+    thread->ticketBoost += AddTickets(thread, amount);
+    kernel->stats->numWakeBoosts++;
+    kernel->stats->wakeBoostPoints += amount;
+}
+
+//----------------------------------------------------------------------
+// Scheduler::DecayBoost
+// 	The running thread "current" ran for another timer tick; take
+//	wakeDecay off whatever is left of its wake-up boost.  Called from
+//	the timer interrupt handler only, not on every Yield, so that the
+//	boost wears off with the time the thread runs, not with how often
+//	it yields.
+//----------------------------------------------------------------------
+
+void
+Scheduler::DecayBoost(Thread *current)
+{
+    int amount = kernel->schedParams->wakeDecay;
+    int tickets = amount;
+
+    if (amount > current->wakeBoost) {
+	amount = current->wakeBoost;
+    }
+    if (amount > 0) {
+	AddPriority(current, -amount);
+	current->wakeBoost -= amount;
+    }
+    if (tickets > current->ticketBoost) {
+	tickets = current->ticketBoost;
+    }
+    if (tickets > 0) {
+	AddTickets(current, -tickets);
+	current->ticketBoost -= tickets;
+    }
+}
+
+//----------------------------------------------------------------------
+// Scheduler::StartTimes
+// 	Start recording the life of "thread", which arrives now -- unless
+//	it is already running (main, which was running before there was
+//	a scheduler), in which case it has been running since boot.
+//----------------------------------------------------------------------
+
+void
+Scheduler::StartTimes(Thread *thread)
+{
+    if (thread == kernel->currentThread) {
+	thread->times = kernel->stats->NewThread(thread->getID(),
+						 thread->getName(), 0);
+	thread->times->firstRun = 0;
+	thread->times->switches = 1;
+    } else {
+	thread->times = kernel->stats->NewThread(thread->getID(),
+				thread->getName(), kernel->stats->totalTicks);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -244,24 +436,45 @@ void
 Scheduler::Run (Thread *nextThread, bool finishing)
 {
     Thread *oldThread = kernel->currentThread;
+    int now = kernel->stats->totalTicks;
     
     ASSERT(kernel->interrupt->getLevel() == IntOff);
 
+    // lifecycle statistics (see ThreadTimes in stats.h)
+    if (oldThread->times == NULL) {
+	StartTimes(oldThread);
+    }
+    if (finishing) {
+	oldThread->times->completion = now;
+    }
+    if (nextThread->times->firstRun < 0) {
+	nextThread->times->firstRun = now;
+    }
+    nextThread->times->readyWait += now - nextThread->times->readySince;
+    nextThread->times->readySince = -1;
+    nextThread->times->switches++;
+
     if (finishing) {	// mark that we need to delete current thread
          ASSERT(toBeDestroyed == NULL);
 	 toBeDestroyed = oldThread;
     }
     
-    if (oldThread->space != NULL) {	// if this thread is a user program,
-        oldThread->SaveUserState(); 	// save the user's CPU registers
-	oldThread->space->SaveState();
-    }
+    // if this thread is a user program, its registers stay in the
+    // machine until another user program needs it (see LoadUserState);
+    // kernel threads in between do not touch them
     
     oldThread->CheckOverflow();		    // check if the old thread
 					    // had an undetected stack overflow
 
     kernel->currentThread = nextThread;  // switch to the next thread
     nextThread->setStatus(RUNNING);      // nextThread is now running
+
+    // start nextThread's time slice; its length depends on the policy
+    // (and, under MLFQ, on the level nextThread came from)
+    if (kernel->alarm != NULL) {
+	kernel->alarm->SetQuantum(realTime->IsRealTime(nextThread) ?
+				  TimerTicks : policy->Quantum(nextThread));
+    }
     
     DEBUG(dbgThread, "Switching from: " << oldThread->getName() << " to: " << nextThread->getName());
     
@@ -294,11 +507,39 @@ Scheduler::Run (Thread *nextThread, bool finishing)
 					// and needs to be cleaned up
     
     if (oldThread->space != NULL) {	    // if there is an address space
-        oldThread->RestoreUserState();     // to restore, do it.
-	oldThread->space->RestoreState();
+        LoadUserState(oldThread);	    // to restore, do it.
     }
 }
 
+//----------------------------------------------------------------------
+// Scheduler::LoadUserState
+// 	Make "thread"'s user registers and page table the ones in the
+//	machine.  This is done lazily: switching to a kernel thread
+//	and back to the same user program leaves the machine alone,
+//	and the registers of a user program are only saved when a
+//	different user program is about to run.
+//----------------------------------------------------------------------
+
+void
+Scheduler::LoadUserState(Thread *thread)
+{
+    ASSERT(thread->space != NULL);
+    if (userStateOwner == thread) {
+	kernel->stats->userStateSkips++;	// still there
+	return;
+    }
+    if (userStateOwner != NULL) {
+	userStateOwner->SaveUserState();
+	userStateOwner->space->SaveState();
+	kernel->stats->userStateSaves++;
+    }
+    thread->RestoreUserState();
+    thread->space->RestoreState();
+    kernel->machine->ClearLink();	// another thread's LL/SC fails
+    kernel->stats->userStateLoads++;
+    userStateOwner = thread;
+}
+
 //----------------------------------------------------------------------
 // Scheduler::CheckToBeDestroyed
 // 	If the old thread gave up the processor because it was finishing,
@@ -311,6 +552,9 @@ void
 Scheduler::CheckToBeDestroyed()
 {
     if (toBeDestroyed != NULL) {
+	if (userStateOwner == toBeDestroyed) {
+	    userStateOwner = NULL;	// nothing left to save
+	}
         delete toBeDestroyed;
 	toBeDestroyed = NULL;
     }
@@ -324,6 +568,21 @@ Scheduler::CheckToBeDestroyed()
 void
 Scheduler::Print()
 {
-    cout << "Ready list contents:\n";
-    //readyList->Apply(ThreadPrint);
+    cout << "Ready list contents (" << policy->getName() << "):\n";
+    realTime->Print();
+    policy->Print();
+}
+
+//----------------------------------------------------------------------
+// Scheduler::PrintStats
+// 	Print what the real-time class, the policy and the burst
+//	predictor keep track of about how well they did.  Called when
+//	Nachos halts.
+//----------------------------------------------------------------------
+void
+Scheduler::PrintStats()
+{
+    realTime->PrintStats();
+    policy->PrintStats();
+    predictor->PrintStats();
 }
@@ -12,14 +12,26 @@
 #include "copyright.h"
 #include "list.h"
 #include "thread.h"
+#include "schedpolicy.h"
+#include "realtime.h"
+#include "schedtrace.h"
+#include "burstpredict.h"
+#include "procgroup.h"
 
 // The following class defines the scheduler/dispatcher abstraction -- 
 // the data structures and operations needed to keep track of which 
 // thread is running, and which threads are ready but not running.
+//
+// Which ready thread runs next, and when the running thread is
+// preempted, is up to the scheduling policy (see schedpolicy.h) --
+// except for real-time threads (see realtime.h), which always run
+// first, and threads of process groups over their CPU share or quota
+// (see procgroup.h), which are held back before the policy sees them.
 
 class Scheduler {
   public:
-    Scheduler();		// Initialize list of ready threads 
+    Scheduler(SchedPolicy *schedPolicy);
+    				// Initialize list of ready threads 
     ~Scheduler();		// De-allocate ready list
 
     void ReadyToRun(Thread* thread);	
@@ -31,20 +43,64 @@ class Scheduler {
     void CheckToBeDestroyed();// Check if thread that had been
     				// running needs to be deleted
     void Print();		// Print contents of ready list
-    void age();
-    void age_util(List<Thread*>*li, ListIterator<Thread *>* it, List<Thread *> *temp);
-    //void reorder();
-    bool preempting;
+    void PrintStats();		// Print the policy's (and the
+				// predictor's) statistics
+
+    bool ShouldYield(Thread* current);
+    				// timer tick: should current give up
+				// the CPU?
+    void Blocked(Thread* thread);
+    				// thread is about to go to sleep
+    void Finished(Thread* thread);
+    				// thread is about to finish
+    void Reorder(Thread* thread);
+    				// thread's priority or burst estimate
+				// changed while it was on the ready list
+    int SetRealTime(Thread* thread, int period, int budget);
+    				// reserve CPU for the running thread
+    bool OverQuota(Thread* thread);
+    				// is thread's process group out of CPU
+				// for now?
+    SchedPolicy *getPolicy() { return policy; }
+    void RecordTrace(TraceRecorder *traceRecorder)
+    				{ recorder = traceRecorder; }
+    				// record a trace of every thread
+    void SetPredictor(BurstPredictor *burstPredictor)
+    		{ delete predictor; predictor = burstPredictor; }
+    				// predict CPU bursts with burstPredictor
+    double PredictBurst(Thread* thread, int burst)
+    				{ return predictor->Update(thread, burst); }
+    				// thread ended a burst; predict its next
+    void AddPriority(Thread* thread, int amount);
+    				// raise (or lower) thread's own priority
+    int AddTickets(Thread* thread, int amount);
+    				// and its stride scheduling tickets
+    void DecayBoost(Thread* current);
+    				// timer tick: current ran for another tick
+    void LoadUserState(Thread* thread);
+    				// put thread's user registers and page
+				// table in the machine, if they aren't
+				// there already
+
     // SelfTest for scheduler is implemented in class Thread
     
   private:
-    List<Thread *> *readyList;  // queue of threads that are ready to run,
-				// but not running
-    SortedList<Thread *> *L1;
-    SortedList<Thread *> *L2;
-    List<Thread *> *L3;
+    SchedPolicy *policy;	// decides who runs next
+    RealTimeClass *realTime;	// real-time threads, which run
+				// before anything the policy picks
     Thread *toBeDestroyed;	// finishing thread to be destroyed
     				// by the next thread that runs
+    Thread *userStateOwner;	// user thread whose registers are in
+				// the machine, NULL if none
+    TraceRecorder *recorder;	// NULL unless recording (-record)
+    BurstPredictor *predictor;	// predicts CPU bursts (-predict)
+    GroupScheduler *groups;	// holds back threads of process groups
+				// over their share or quota
+
+    void StartTimes(Thread* thread);
+    				// start thread's lifecycle statistics
+    void BoostOnWake(Thread* thread);
+    				// thread was woken by an interrupt
 };
 
 #endif // SCHEDULER_H
@@ -0,0 +1,128 @@
+// stackpool.cc
+//	Routines to allocate thread stacks from a pool of recycled ones.
+//	See stackpool.h.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "stackpool.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// StackBucket::StackBucket, StackBucket::~StackBucket
+//	Initialize the (empty) free list for stacks of "stackWords"
+//	words; and give the stacks on it back to the host.
+//----------------------------------------------------------------------
+
+StackBucket::StackBucket(int stackWords)
+{
+    words = stackWords;
+    free = new List<int *>;
+}
+
+StackBucket::~StackBucket()
+{
+    while (!free->IsEmpty()) {
+	DeallocBoundedArray((char *) free->RemoveFront(), words * sizeof(int));
+    }
+    delete free;
+}
+
+//----------------------------------------------------------------------
+// StackPool::StackPool
+//	Initialize an empty stack pool.  "maxFreeStacks" of 0 turns
+//	recycling off: every stack is freed as soon as its thread is.
+//----------------------------------------------------------------------
+
+StackPool::StackPool(int maxFreeStacks)
+{
+    ASSERT(maxFreeStacks >= 0);
+    buckets = new List<StackBucket *>;
+    maxFree = maxFreeStacks;
+}
+
+//----------------------------------------------------------------------
+// StackPool::~StackPool
+//	Free every free stack.
+//----------------------------------------------------------------------
+
+StackPool::~StackPool()
+{
+    while (!buckets->IsEmpty()) {
+	delete buckets->RemoveFront();
+    }
+    delete buckets;
+}
+
+//----------------------------------------------------------------------
+// StackPool::Bucket
+//	Return the free list for stacks of "words" words, making it if
+//	this is the first stack of that size.  There are only ever a
+//	few sizes, so a list is good enough.
+//----------------------------------------------------------------------
+
+StackBucket *
+StackPool::Bucket(int words)
+{
+    ListIterator<StackBucket *> iter(buckets);
+    StackBucket *bucket;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	if (iter.Item()->words == words) {
+	    return iter.Item();
+	}
+    }
+    bucket = new StackBucket(words);
+    buckets->Append(bucket);
+    return bucket;
+}
+
+//----------------------------------------------------------------------
+// StackPool::Allocate
+//	Return a stack of "words" words: a free one if there is one,
+//	else a new one from AllocBoundedArray.
+//----------------------------------------------------------------------
+
+int *
+StackPool::Allocate(int words)
+{
+    StackBucket *bucket = Bucket(words);
+    Statistics *stats = kernel->stats;
+    int *stack;
+
+    if (!bucket->free->IsEmpty()) {
+	stack = bucket->free->RemoveFront();
+	stats->stackReuses++;
+    } else {
+	stack = (int *) AllocBoundedArray(words * sizeof(int));
+	stats->stackAllocs++;
+    }
+    stats->stackBytes += words * sizeof(int);
+    if (stats->stackBytes > stats->peakStackBytes) {
+	stats->peakStackBytes = stats->stackBytes;
+    }
+    return stack;
+}
+
+//----------------------------------------------------------------------
+// StackPool::Free
+//	"stack", of "words" words, is no longer used.  Keep it for the
+//	next thread, unless we already have enough of that size.
+//----------------------------------------------------------------------
+
+void
+StackPool::Free(int *stack, int words)
+{
+    StackBucket *bucket = Bucket(words);
+    int numFree = bucket->free->NumInList();
+
+    kernel->stats->stackBytes -= words * sizeof(int);
+    if (numFree < maxFree) {
+	bucket->free->Append(stack);
+    } else {
+	DeallocBoundedArray((char *) stack, words * sizeof(int));
+    }
+}
@@ -0,0 +1,55 @@
+// stackpool.h
+//	Data structures to recycle thread execution stacks.
+//
+//	Every stack comes from AllocBoundedArray, which maps guard pages
+//	on either side of it (two mprotect calls), and goes back through
+//	DeallocBoundedArray (two more).  Forking many short-lived threads
+//	spends most of its time doing that, so instead a finished
+//	thread's stack goes on a free list, guard pages and all, and the
+//	next thread that wants a stack of the same size gets it back.
+//	At most "maxFree" stacks of each size are kept (-stackpool).
+//
+//	The pool also keeps track of how much memory the stacks of
+//	living threads take, now and at the most, for Statistics.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef STACKPOOL_H
+#define STACKPOOL_H
+
+#include "copyright.h"
+#include "list.h"
+
+// The following class is the set of free stacks of one size.
+
+class StackBucket {
+  public:
+    StackBucket(int stackWords);
+    ~StackBucket();		// frees the stacks
+
+    int words;			// size of the stacks, in words
+    List<int *> *free;		// free stacks of that size
+};
+
+// The following class is the stack pool.
+
+class StackPool {
+  public:
+    StackPool(int maxFreeStacks);	// keep at most maxFreeStacks
+					// free stacks of each size
+    ~StackPool();			// free all the free stacks
+
+    int *Allocate(int words);	// a stack of "words" words
+    void Free(int *stack, int words);
+    				// done with "stack"
+
+  private:
+    List<StackBucket *> *buckets;	// one per size ever asked for
+    int maxFree;		// free stacks kept, per size
+
+    StackBucket *Bucket(int words);	// the bucket for a size
+};
+
+#endif // STACKPOOL_H
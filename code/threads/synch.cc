@@ -25,6 +25,10 @@
 // whether the lock is held or not -- a semaphore value of 0 means
 // the lock is busy; a semaphore value of 1 means the lock is free.
 //
+// Locks also keep track of the threads waiting for them, so that the
+// holder can inherit their priority (see synch.h); the semaphore
+// itself still decides who gets the lock next.
+//
 // The implementation of condition variables using semaphores is
 // a bit trickier, as explained below under Condition::Wait.
 //
@@ -42,13 +46,19 @@
 //
 //	"debugName" is an arbitrary name, useful for debugging.
 //	"initialValue" is the initial value of the semaphore.
+//	"profiled" is FALSE if -lockprof should leave it out (say, if
+//		it is part of a lock, which is profiled instead).
 //----------------------------------------------------------------------
 
-Semaphore::Semaphore(char* debugName, int initialValue)
+Semaphore::Semaphore(char* debugName, int initialValue, bool profiled)
 {
     name = debugName;
     value = initialValue;
-    queue = new List<Thread *>;
+    queue = new IntrusiveList<Thread *>(QueueLink);
+    profile = NULL;
+    if (profiled && kernel->lockProfiler != NULL) {
+	profile = kernel->lockProfiler->Register(debugName, FALSE);
+    }
 }
 
 //----------------------------------------------------------------------
@@ -81,12 +91,17 @@ Semaphore::P()
     
     // disable interrupts
     IntStatus oldLevel = interrupt->SetLevel(IntOff);	
+    bool waited = (value == 0);
+    int waitStart = kernel->stats->totalTicks;
     
     while (value == 0) { 		// semaphore not available
 	queue->Append(currentThread);	// so go to sleep
 	currentThread->Sleep(FALSE);
     } 
     value--; 			// semaphore available, consume its value
+    if (profile != NULL) {
+	profile->Acquired(waited, kernel->stats->totalTicks - waitStart, NULL);
+    }
    
     // re-enable interrupts
     (void) interrupt->SetLevel(oldLevel);	
@@ -160,8 +175,16 @@ Semaphore::SelfTest()
 Lock::Lock(char* debugName)
 {
     name = debugName;
-    semaphore = new Semaphore("lock", 1);  // initially, unlocked
+    semaphore = new Semaphore("lock", 1, FALSE);  // initially, unlocked
     lockHolder = NULL;
+    waiters = new IntrusiveList<Thread *>(WaiterLink);
+    ceiling = -1;
+    nextHeld = NULL;
+    profile = NULL;
+    if (kernel->lockProfiler != NULL) {
+	profile = kernel->lockProfiler->Register(debugName, TRUE);
+    }
+    acquiredAt = 0;
 }
 
 //----------------------------------------------------------------------
@@ -171,6 +194,7 @@ Lock::Lock(char* debugName)
 Lock::~Lock()
 {
     delete semaphore;
+    delete waiters;
 }
 
 //----------------------------------------------------------------------
@@ -178,12 +202,56 @@ Lock::~Lock()
 //	Atomically wait until the lock is free, then set it to busy.
 //	Equivalent to Semaphore::P(), with the semaphore value of 0
 //	equal to busy, and semaphore value of 1 equal to free.
+//
+//	While we wait, the holder runs at (at least) our priority.  If
+//	it was running below it, that is a priority inversion; count it,
+//	and how long we were held up.
 //----------------------------------------------------------------------
 
 void Lock::Acquire()
 {
+    Thread *current = kernel->currentThread;
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    int invertedAt = -1;
+    int waitStart = kernel->stats->totalTicks;
+    char *holderName = NULL;
+
+    if (lockHolder != NULL) {		// we'll have to wait
+	holderName = lockHolder->getName();
+	if (lockHolder->priority < current->priority) {
+	    invertedAt = kernel->stats->totalTicks;
+	    kernel->stats->numInversions++;
+	}
+	waiters->Append(current);
+	current->waitingFor = this;
+	Boost(current->priority);
+    }
     semaphore->P();
-    lockHolder = kernel->currentThread;
+    if (current->waitingFor == this) {
+	waiters->Remove(current);
+	current->waitingFor = NULL;
+    }
+    if (invertedAt >= 0) {
+	int ticks = kernel->stats->totalTicks - invertedAt;
+
+	DEBUG(dbgSynch, "Thread " << current->getName() << " waited " << ticks
+	      << " ticks for lock " << name << " held at lower priority");
+	kernel->stats->inversionTicks += ticks;
+	if (ticks > kernel->stats->maxInversionTicks) {
+	    kernel->stats->maxInversionTicks = ticks;
+	}
+    }
+
+    if (profile != NULL) {
+	profile->Acquired(holderName != NULL,
+			  kernel->stats->totalTicks - waitStart, holderName);
+    }
+    acquiredAt = kernel->stats->totalTicks;
+    lockHolder = current;
+    nextHeld = current->locksHeld;
+    current->locksHeld = this;
+    Boost(Inherited());		// from those still waiting, or the ceiling
+    (void) kernel->interrupt->SetLevel(oldLevel);
 }
 
 //----------------------------------------------------------------------
@@ -199,9 +267,101 @@ void Lock::Acquire()
 
 void Lock::Release()
 {
+    Thread *current = kernel->currentThread;
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    Lock **link;
+
     ASSERT(IsHeldByCurrentThread());
+    if (profile != NULL) {
+	profile->Released(kernel->stats->totalTicks - acquiredAt);
+    }
     lockHolder = NULL;
+    for (link = &current->locksHeld; *link != this; link = &(*link)->nextHeld) {
+	ASSERT(*link != NULL);
+    }
+    *link = nextHeld;
+    nextHeld = NULL;
+    Restore(current);
     semaphore->V();
+    (void) kernel->interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// Lock::Inherited
+//	Return the priority the holder of the lock must run at (at
+//	least): the highest priority of the threads waiting for it, or
+//	the ceiling, if that is higher.  -1 if neither.
+//----------------------------------------------------------------------
+
+int
+Lock::Inherited()
+{
+    IntrusiveListIterator<Thread *> iter(waiters);
+    int priority = ceiling;
+
+    for (; !iter.IsDone(); iter.Next()) {
+	if (iter.Item()->priority > priority) {
+	    priority = iter.Item()->priority;
+	}
+    }
+    return priority;
+}
+
+//----------------------------------------------------------------------
+// Lock::Boost
+//	Raise the holder of the lock to "priority", if it is below it.
+//	If the holder is itself waiting for a lock, do the same for that
+//	lock's holder, and so on down the chain.  A holder that is on the
+//	ready list is moved to where its new priority puts it.
+//----------------------------------------------------------------------
+
+void
+Lock::Boost(int priority)
+{
+    Lock *lock = this;
+    Thread *holder;
+
+    ASSERT(kernel->interrupt->getLevel() == IntOff);
+    while (lock != NULL && lock->lockHolder != NULL &&
+	   lock->lockHolder->priority < priority) {
+	holder = lock->lockHolder;
+	if (holder->basePriority < 0) {
+	    holder->basePriority = holder->priority;
+	}
+	DEBUG(dbgSynch, "Thread " << holder->getName() << " inherits priority "
+	      << priority << " for lock " << lock->name);
+	holder->priority = priority;
+	kernel->scheduler->Reorder(holder);
+	lock = holder->waitingFor;
+    }
+}
+
+//----------------------------------------------------------------------
+// Lock::Restore
+//	"thread" has just released this lock; drop it back to its own
+//	priority, or to what the locks it still holds call for.
+//----------------------------------------------------------------------
+
+void
+Lock::Restore(Thread *thread)
+{
+    int priority;
+
+    if (thread->basePriority < 0) {	// was never raised
+	return;
+    }
+    priority = thread->basePriority;
+    for (Lock *lock = thread->locksHeld; lock != NULL; lock = lock->nextHeld) {
+	if (lock->Inherited() > priority) {
+	    priority = lock->Inherited();
+	}
+    }
+    DEBUG(dbgSynch, "Thread " << thread->getName() << " back to priority "
+	  << priority << " after releasing lock " << name);
+    thread->priority = priority;
+    if (priority == thread->basePriority) {
+	thread->basePriority = -1;
+    }
 }
 
 //----------------------------------------------------------------------
@@ -212,30 +372,32 @@ void Lock::Release()
 //
 //	"debugName" is an arbitrary name, useful for debugging.
 //----------------------------------------------------------------------
+
 Condition::Condition(char* debugName)
 {
     name = debugName;
-    waitQueue = new List<Semaphore *>;
+    firstWaiter = lastWaiter = NULL;
 }
 
 //----------------------------------------------------------------------
 // Condition::Condition
 // 	Deallocate the data structures implementing a condition variable.
+//	There are none.
 //----------------------------------------------------------------------
 
 Condition::~Condition()
 {
-    delete waitQueue;
+    ASSERT(firstWaiter == NULL);
 }
 
 //----------------------------------------------------------------------
 // Condition::Wait
 // 	Atomically release monitor lock and go to sleep.
-//	Our implementation uses semaphores to implement this, by
-//	allocating a semaphore for each waiting thread.  The signaller
-//	will V() this semaphore, so there is no chance the waiter
-//	will miss the signal, even though the lock is released before
-//	calling P().
+//	The waiting thread is chained onto the condition through its
+//	own nextWaiter field, so waiting allocates nothing.  Interrupts
+//	are disabled from before the lock is released until the thread
+//	is asleep, so there is no chance the waiter will miss the
+//	signal.
 //
 //	Note: we assume Mesa-style semantics, which means that the
 //	waiter must re-acquire the monitor lock when waking up.
@@ -245,16 +407,23 @@ Condition::~Condition()
 
 void Condition::Wait(Lock* conditionLock) 
 {
-     Semaphore *waiter;
+     Thread *currentThread = kernel->currentThread;
+     IntStatus oldLevel;
     
      ASSERT(conditionLock->IsHeldByCurrentThread());
 
-     waiter = new Semaphore("condition", 0);
-     waitQueue->Append(waiter);
+     oldLevel = kernel->interrupt->SetLevel(IntOff);
+     currentThread->nextWaiter = NULL;
+     if (lastWaiter == NULL) {
+	 firstWaiter = currentThread;
+     } else {
+	 lastWaiter->nextWaiter = currentThread;
+     }
+     lastWaiter = currentThread;
      conditionLock->Release();
-     waiter->P();
+     currentThread->Sleep(FALSE);
+     (void) kernel->interrupt->SetLevel(oldLevel);
      conditionLock->Acquire();
-     delete waiter;
 }
 
 //----------------------------------------------------------------------
@@ -267,20 +436,29 @@ void Condition::Wait(Lock* conditionLock)
 //
 //	Also note: we assume the caller holds the monitor lock
 //	(unlike what is described in Birrell's paper).  This allows
-//	us to access waitQueue without disabling interrupts.
+//	us to access the waiting threads without disabling interrupts;
+//	they are only disabled because Scheduler::ReadyToRun needs it.
 //
 //	"conditionLock" -- lock protecting the use of this condition
 //----------------------------------------------------------------------
 
 void Condition::Signal(Lock* conditionLock)
 {
-    Semaphore *waiter;
+    Thread *waiter;
     
     ASSERT(conditionLock->IsHeldByCurrentThread());
     
-    if (!waitQueue->IsEmpty()) {
-        waiter = waitQueue->RemoveFront();
-	waiter->V();
+    if (firstWaiter != NULL) {
+	IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+
+        waiter = firstWaiter;
+	firstWaiter = waiter->nextWaiter;
+	if (firstWaiter == NULL) {
+	    lastWaiter = NULL;
+	}
+	waiter->nextWaiter = NULL;
+	kernel->scheduler->ReadyToRun(waiter);
+	(void) kernel->interrupt->SetLevel(oldLevel);
     }
 }
 
@@ -293,7 +471,290 @@ void Condition::Signal(Lock* conditionLock)
 
 void Condition::Broadcast(Lock* conditionLock) 
 {
-    while (!waitQueue->IsEmpty()) {
+    while (firstWaiter != NULL) {
         Signal(conditionLock);
     }
 }
+
+//----------------------------------------------------------------------
+// RWLock::RWLock
+// 	Initialize a reader-writer lock, so that it can be used for
+//	synchronization.  Initially, nobody holds it.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//	"isFair" is TRUE if readers must not be starved by writers.
+//----------------------------------------------------------------------
+
+RWLock::RWLock(char* debugName, bool isFair)
+{
+    name = debugName;
+    fair = isFair;
+    lock = new Lock(debugName);
+    okToRead = new Condition(debugName);
+    okToWrite = new Condition(debugName);
+    readers = 0;
+    writer = NULL;
+    waitingReaders = waitingWriters = readBatch = 0;
+    readGeneration = 0;
+    waitSignal = NULL;
+    numReads = numWrites = readWaits = writeWaits = 0;
+}
+
+//----------------------------------------------------------------------
+// RWLock::~RWLock
+// 	Deallocate a reader-writer lock.  Assume nobody holds it.
+//----------------------------------------------------------------------
+
+RWLock::~RWLock()
+{
+    ASSERT(readers == 0 && writer == NULL);
+    delete okToWrite;
+    delete okToRead;
+    delete lock;
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireRead
+// 	Wait until no writer holds the lock, and none is waiting for it
+//	(unless this reader is one a fair lock lets in first), then
+//	hold the lock along with any other readers.
+//----------------------------------------------------------------------
+
+void
+RWLock::AcquireRead()
+{
+    bool waited = FALSE;
+    int generation;
+
+    lock->Acquire();
+    generation = readGeneration;
+    waitingReaders++;
+    while (writer != NULL || (waitingWriters > 0 && !InBatch(generation))) {
+	if (!waited && waitSignal != NULL) {
+	    waitSignal->V();
+	}
+	waited = TRUE;
+	okToRead->Wait(lock);
+    }
+    waitingReaders--;
+    if (InBatch(generation)) {
+	readBatch--;
+    }
+    readers++;
+    numReads++;
+    if (waited) {
+	readWaits++;
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseRead
+// 	Stop reading; the last reader out lets a writer in.
+//----------------------------------------------------------------------
+
+void
+RWLock::ReleaseRead()
+{
+    lock->Acquire();
+    ASSERT(readers > 0);
+    readers--;
+    if (readers == 0 && waitingWriters > 0) {
+	okToWrite->Signal(lock);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::AcquireWrite
+// 	Wait until nobody holds the lock, and no reader a fair lock has
+//	promised to let in first is still waiting, then hold it alone.
+//----------------------------------------------------------------------
+
+void
+RWLock::AcquireWrite()
+{
+    bool waited = FALSE;
+
+    lock->Acquire();
+    ASSERT(writer != kernel->currentThread);
+    waitingWriters++;
+    while (writer != NULL || readers > 0 || readBatch > 0) {
+	if (!waited && waitSignal != NULL) {
+	    waitSignal->V();
+	}
+	waited = TRUE;
+	okToWrite->Wait(lock);
+    }
+    waitingWriters--;
+    writer = kernel->currentThread;
+    numWrites++;
+    if (waited) {
+	writeWaits++;
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::ReleaseWrite
+// 	Stop writing.  Writers have preference, so the next waiting
+//	writer gets the lock, unless the lock is fair and readers are
+//	waiting, in which case those readers go first.
+//----------------------------------------------------------------------
+
+void
+RWLock::ReleaseWrite()
+{
+    lock->Acquire();
+    ASSERT(IsWriteHeldByCurrentThread());
+    writer = NULL;
+    if (fair && waitingReaders > 0) {
+	readBatch = waitingReaders;	// only those waiting now
+	readGeneration++;
+	okToRead->Broadcast(lock);
+    } else if (waitingWriters > 0) {
+	okToWrite->Signal(lock);
+    } else {
+	okToRead->Broadcast(lock);
+    }
+    lock->Release();
+}
+
+//----------------------------------------------------------------------
+// RWLock::PrintStats
+// 	Print how often the lock was acquired for reading and writing,
+//	and how often that had to wait.
+//----------------------------------------------------------------------
+
+void
+RWLock::PrintStats()
+{
+    cout << "RWLock " << name << ": reads " << numReads;
+    cout << " (" << readWaits << " waited), writes " << numWrites;
+    cout << " (" << writeWaits << " waited)\n";
+}
+
+//----------------------------------------------------------------------
+// RWLock::SelfTest, RWLockReader, RWLockWriter
+// 	Test the reader-writer lock: two readers can hold it at once,
+//	a reader waits while a writer holds it, and a reader arriving
+//	after a waiting writer waits behind it.  If the lock is fair,
+//	also test that the readers waiting when a writer finishes get in
+//	before the next writer, but a reader arriving after that does not.
+//
+//	The threads are lined up with semaphores, not by yielding, so
+//	that the test works under every scheduling policy: the lock V's
+//	"waitSignal" as a thread starts to wait, and a reader holds the
+//	lock until it is told to let go.
+//----------------------------------------------------------------------
+
+static RWLock *testLock;
+static Semaphore *testDone;		// a helper has finished
+static Semaphore *testHeld;		// a reader is holding testLock
+static int inside;			// readers holding testLock, or -1
+					// if the writer (or this thread) does
+static char testOrder[4];		// who got testLock, in order
+static int testSteps;
+
+static void
+RWLockReader(void *release)
+{
+    testLock->AcquireRead();
+    ASSERT(inside >= 0);
+    inside++;
+    testOrder[testSteps++] = 'r';
+    if (release != NULL) {		// hold it until told to let go
+	testHeld->V();
+	((Semaphore *) release)->P();
+    }
+    inside--;
+    testLock->ReleaseRead();
+    testDone->V();
+}
+
+static void
+RWLockWriter(void *unused)
+{
+    testLock->AcquireWrite();
+    ASSERT(inside == 0);
+    inside = -1;
+    testOrder[testSteps++] = 'w';
+    inside = 0;
+    testLock->ReleaseWrite();
+    testDone->V();
+}
+
+void
+RWLock::SelfTest()
+{
+    Semaphore *release = new Semaphore("rwlock release", 0);
+
+    ASSERT(readers == 0 && writer == NULL);
+    testLock = this;
+    testDone = new Semaphore("rwlock test", 0);
+    testHeld = new Semaphore("rwlock held", 0);
+    waitSignal = new Semaphore("rwlock wait", 0);
+    inside = 0;
+
+    // two readers share the lock
+    testSteps = 0;
+    (new Thread("reader", 1))->Fork((VoidFunctionPtr) RWLockReader, release);
+    (new Thread("reader", 1))->Fork((VoidFunctionPtr) RWLockReader, release);
+    testHeld->P();
+    testHeld->P();
+    ASSERT(inside == 2);
+    release->V();
+    release->V();
+    testDone->P();
+    testDone->P();
+
+    // a reader waits for the writer
+    testSteps = 0;
+    AcquireWrite();
+    inside = -1;
+    (new Thread("reader", 1))->Fork((VoidFunctionPtr) RWLockReader, NULL);
+    waitSignal->P();			// the reader is waiting
+    inside = 0;
+    ReleaseWrite();
+    testDone->P();
+
+    // a reader arriving after a waiting writer waits behind it
+    testSteps = 0;
+    AcquireRead();
+    (new Thread("writer", 1))->Fork((VoidFunctionPtr) RWLockWriter, NULL);
+    waitSignal->P();
+    (new Thread("reader", 1))->Fork((VoidFunctionPtr) RWLockReader, NULL);
+    waitSignal->P();
+    ReleaseRead();
+    testDone->P();
+    testDone->P();
+    ASSERT(testOrder[0] == 'w' && testOrder[1] == 'r');
+
+    // a fair lock lets in the reader waiting when the writer finishes,
+    // ahead of the next writer; this thread, reading after that, waits
+    // behind the writer instead of taking the waiting reader's place
+    if (fair) {
+	testSteps = 0;
+	AcquireWrite();
+	(new Thread("reader", 1))->Fork((VoidFunctionPtr) RWLockReader, NULL);
+	waitSignal->P();
+	(new Thread("writer", 1))->Fork((VoidFunctionPtr) RWLockWriter, NULL);
+	waitSignal->P();
+	ReleaseWrite();
+	AcquireRead();
+	testOrder[testSteps++] = 'm';
+	ReleaseRead();
+	waitSignal->P();		// this thread had to wait, too
+	testDone->P();
+	testDone->P();
+	ASSERT(testOrder[0] == 'r' && testOrder[1] == 'w'
+	       && testOrder[2] == 'm');
+    }
+
+    ASSERT(readers == 0 && writer == NULL);
+    delete waitSignal;
+    waitSignal = NULL;
+    delete testHeld;
+    delete testDone;
+    delete release;
+}
@@ -20,7 +20,9 @@
 #include "copyright.h"
 #include "thread.h"
 #include "list.h"
+#include "intrusivelist.h"
 #include "main.h"
+#include "lockprof.h"
 
 // The following class defines a "semaphore" whose value is a non-negative
 // integer.  The semaphore has only two operations P() and V():
@@ -39,7 +41,8 @@
 
 class Semaphore {
   public:
-    Semaphore(char* debugName, int initialValue);	// set initial value
+    Semaphore(char* debugName, int initialValue, bool profiled = TRUE);
+    							// set initial value
     ~Semaphore();   					// de-allocate semaphore
     char* getName() { return name;}			// debugging assist
     
@@ -50,8 +53,9 @@ class Semaphore {
   private:
     char* name;        // useful for debugging
     int value;         // semaphore value, always >= 0
-    List<Thread *> *queue;     
+    IntrusiveList<Thread *> *queue;     
 		  	// threads waiting in P() for the value to be > 0
+    LockProfile *profile;	// contention, NULL unless -lockprof
    };
 
 // The following class defines a "lock".  A lock can be BUSY or FREE.
@@ -65,6 +69,16 @@ class Semaphore {
 // In addition, by convention, only the thread that acquired the lock
 // may release it.  As with semaphores, you can't read the lock value
 // (because the value might change immediately after you read it).  
+//
+// To keep a low priority thread holding a lock from holding up the
+// higher priority threads waiting for it, locks use priority
+// inheritance: while a thread holds locks, its priority is raised to
+// that of the highest priority thread waiting for any of them (and,
+// if the holder is itself waiting for a lock, so is the priority of
+// that lock's holder, and so on).  A lock can also be given a priority
+// ceiling, which its holder is raised to as soon as it acquires it.
+// Either way, the holder drops back to its own priority as it releases
+// the locks.
 
 class Lock {
   public:
@@ -79,6 +93,8 @@ class Lock {
     		return lockHolder == kernel->currentThread; }
     				// return true if the current thread 
 				// holds this lock.
+    void SetCeiling(int priority) { ceiling = priority; }
+    				// raise holders to at least "priority"
     
     // Note: SelfTest routine provided by SynchList
     
@@ -86,6 +102,17 @@ class Lock {
     char *name;			// debugging assist
     Thread *lockHolder;		// thread currently holding lock
     Semaphore *semaphore;	// we use a semaphore to implement lock
+    IntrusiveList<Thread *> *waiters;	// threads waiting in Acquire
+    int ceiling;		// priority ceiling, -1 if none
+    Lock *nextHeld;		// next lock held by lockHolder
+    LockProfile *profile;	// contention, NULL unless -lockprof
+    int acquiredAt;		// when lockHolder got it, for profile
+
+    int Inherited();		// priority the holder must have
+    void Boost(int priority);	// raise the holder, and the holders
+				// of the locks it waits for
+    void Restore(Thread *thread);// drop thread to the priority it
+				// has without this lock
 };
 
 // The following class defines a "condition variable".  A condition
@@ -139,6 +166,63 @@ class Condition {
 
   private:
     char* name;
-    List<Semaphore *> *waitQueue;	// list of waiting threads
+    Thread *firstWaiter;		// threads waiting, chained through
+    Thread *lastWaiter;			// Thread::nextWaiter
+};
+
+// The following class defines a "reader-writer lock".  Any number of
+// threads can hold it for reading at once, or one thread for writing.
+//
+// Writers have preference: once a writer is waiting, new readers wait
+// behind it, so a steady stream of readers cannot starve writers.  If
+// the lock is "fair", readers cannot be starved either: when a writer
+// releases the lock, the readers waiting at that moment all get in
+// before the next writer does.
+
+class RWLock {
+  public:
+    RWLock(char* debugName, bool isFair = FALSE);
+    					// initialize lock to be FREE
+    ~RWLock();				// deallocate lock
+    char* getName() { return name; }
+
+    void AcquireRead();			// share the lock with other readers
+    void ReleaseRead();
+    void AcquireWrite();		// hold the lock alone
+    void ReleaseWrite();
+
+    bool IsWriteHeldByCurrentThread()
+    		{ return writer == kernel->currentThread; }
+
+    void PrintStats();			// acquisitions, and how many waited
+    void SelfTest();			// test the RWLock implementation
+
+  private:
+    char* name;				// for debugging
+    bool fair;				// let waiting readers in between
+					// writers?
+    Lock *lock;				// protects the fields below
+    Condition *okToRead;		// readers wait here
+    Condition *okToWrite;		// writers wait here
+    int readers;			// threads holding it for reading
+    Thread *writer;			// thread holding it for writing
+    int waitingReaders;
+    int waitingWriters;
+    int readBatch;			// waiting readers to let in before
+					// the next writer (if "fair")
+    int readGeneration;			// bumped whenever a batch is let
+					// in; readers that arrived since
+					// are not part of it
+    Semaphore *waitSignal;		// if not NULL, V'd when a thread
+					// starts to wait; for SelfTest
+
+    bool InBatch(int generation)	// is a reader that arrived at
+    		{ return readBatch > 0 && generation != readGeneration; }
+					// "generation" in the batch?
+
+    int numReads;			// statistics
+    int numWrites;
+    int readWaits;			// acquisitions that had to wait
+    int writeWaits;
 };
 #endif // SYNCH_H
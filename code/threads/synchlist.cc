@@ -17,14 +17,20 @@
 //	Allocate and initialize the data structures needed for a 
 //	synchronized list, empty to start with.
 //	Elements can now be added to the list.
+//
+//	"maxItems" is the most items the list may hold at once, or 0
+//	if there is no limit.
 //----------------------------------------------------------------------
 
 template <class T>
-SynchList<T>::SynchList()
+SynchList<T>::SynchList(int maxItems)
 {
+    ASSERT(maxItems >= 0);
     list = new List<T>;
     lock = new Lock("list lock"); 
     listEmpty = new Condition("list empty cond");
+    listFull = new Condition("list full cond");
+    capacity = maxItems;
 }
 
 //----------------------------------------------------------------------
@@ -35,6 +41,7 @@ SynchList<T>::SynchList()
 template <class T>
 SynchList<T>::~SynchList()
 { 
+    delete listFull;
     delete listEmpty;
     delete lock;
     delete list;
@@ -45,6 +52,8 @@ SynchList<T>::~SynchList()
 //      Append an "item" to the end of the list.  Wake up anyone
 //	waiting for an element to be appended.
 //
+//	If the list is full, wait until there is room.
+//
 //	"item" is the thing to put on the list. 
 //----------------------------------------------------------------------
 
@@ -53,11 +62,74 @@ void
 SynchList<T>::Append(T item)
 {
     lock->Acquire();		// enforce mutual exclusive access to the list 
+    while (IsFull())
+	listFull->Wait(lock);	// wait until there is room
     list->Append(item);
     listEmpty->Signal(lock);	// wake up a waiter, if any
     lock->Release();
 }
 
+//----------------------------------------------------------------------
+// SynchList<T>::TryAppend
+//      Append an "item" to the end of the list, as in Append, but
+//	only if there is room for it; never wait.  For callers that
+//	would rather drop an item than block, such as the post office.
+//
+//	"item" is the thing to put on the list. 
+// Returns:
+//	FALSE if the list was full, and the item was not appended.
+//----------------------------------------------------------------------
+
+template <class T>
+bool
+SynchList<T>::TryAppend(T item)
+{
+    bool appended = FALSE;
+
+    lock->Acquire();
+    if (!IsFull()) {
+	list->Append(item);
+	listEmpty->Signal(lock);
+	appended = TRUE;
+    }
+    lock->Release();
+    return appended;
+}
+
+//----------------------------------------------------------------------
+// SynchList<T>::AppendMany
+//      Append "n" items to the end of the list, in order, acquiring
+//	the lock and waking up waiters once for the whole batch, rather
+//	than once per item.  If the list fills up part way, wake up the
+//	waiters for what has been appended so far, and wait for room
+//	for the rest.
+//
+//	"items" is an array of the things to put on the list.
+//	"n" is how many there are.
+//----------------------------------------------------------------------
+
+template <class T>
+void
+SynchList<T>::AppendMany(T *items, int n)
+{
+    int i = 0;
+
+    lock->Acquire();
+    while (i < n) {
+	int start = i;
+
+	while (IsFull())
+	    listFull->Wait(lock);
+	while (i < n && !IsFull())
+	    list->Append(items[i++]);
+	if (i - start == 1)
+	    listEmpty->Signal(lock);	// as in Append
+	else
+	    listEmpty->Broadcast(lock);	// there is enough for everyone
+    }
+    lock->Release();
+}
+
 //----------------------------------------------------------------------
 // SynchList<T>::RemoveFront
 //      Remove an "item" from the beginning of the list.  Wait if
@@ -76,10 +148,47 @@ SynchList<T>::RemoveFront()
     while (list->IsEmpty())
 	listEmpty->Wait(lock);		// wait until list isn't empty
     item = list->RemoveFront();
+    if (capacity > 0)
+	listFull->Signal(lock);		// wake up an appender, if any
     lock->Release();
     return item;
 }
 
+//----------------------------------------------------------------------
+// SynchList<T>::RemoveUpTo
+//      Remove as many as "n" items from the beginning of the list, in
+//	order, with one lock acquire; wait if the list is empty.  If
+//	the list is bounded, wake up the threads waiting for room once
+//	for the whole batch.
+//
+//	"items" is an array to put the removed things in.
+//	"n" is its size.
+// Returns:
+//	How many items were removed; at least one.
+//----------------------------------------------------------------------
+
+template <class T>
+int
+SynchList<T>::RemoveUpTo(T *items, int n)
+{
+    int count = 0;
+
+    ASSERT(n > 0);
+    lock->Acquire();
+    while (list->IsEmpty())
+	listEmpty->Wait(lock);
+    while (count < n && !list->IsEmpty())
+	items[count++] = list->RemoveFront();
+    if (capacity > 0) {
+	if (count == 1)
+	    listFull->Signal(lock);
+	else
+	    listFull->Broadcast(lock);
+    }
+    lock->Release();
+    return count;
+}
+
 //----------------------------------------------------------------------
 // SynchList<T>::Apply
 //      Apply function to every item on a list.
@@ -97,10 +206,11 @@ SynchList<T>::Apply(void (*func)(T))
 }
 
 //----------------------------------------------------------------------
-// SynchList<T>::SelfTest, SelfTestHelper
+// SynchList<T>::SelfTest, SelfTestHelper, SelfTestBatchHelper
 //	Test whether the SynchList implementation is working,
 //	by having two threads ping-pong a value between them
-//	using two synchronized lists.
+//	using two synchronized lists.  Then do it again in batches,
+//	through a list too small to hold a whole batch.
 //----------------------------------------------------------------------
 
 template <class T>
@@ -113,6 +223,21 @@ SynchList<T>::SelfTestHelper (void* data)
     }
 }
 
+template <class T>
+void
+SynchList<T>::SelfTestBatchHelper (void* data) 
+{
+    SynchList<T>* _this = (SynchList<T>*)data;
+    T items[4];
+
+    for (int i = 0; i < 10; ) {
+	int n = _this->selfTestPing->RemoveUpTo(items, 4);
+
+        _this->AppendMany(items, n);
+	i += n;
+    }
+}
+
 template <class T>
 void
 SynchList<T>::SelfTest(T val)
@@ -127,4 +252,26 @@ SynchList<T>::SelfTest(T val)
 	ASSERT(val == this->RemoveFront());
     }
     delete selfTestPing;
+
+    T items[10];
+
+    selfTestPing = new SynchList<T>(2);
+    ASSERT(selfTestPing->TryAppend(val) && selfTestPing->TryAppend(val));
+    ASSERT(!selfTestPing->TryAppend(val));
+    ASSERT(selfTestPing->RemoveUpTo(items, 10) == 2);
+    for (int i = 0; i < 10; i++) {
+	items[i] = val;
+    }
+    helper = new Thread("batch ping", 1);
+    helper->Fork(SynchList<T>::SelfTestBatchHelper, this);
+    selfTestPing->AppendMany(items, 10);	// waits for room, 2 at a time
+    for (int i = 0; i < 10; ) {
+	int n = this->RemoveUpTo(items, 10 - i);
+
+	for (int j = 0; j < n; j++) {
+	    ASSERT(val == items[j]);
+	}
+	i += n;
+    }
+    delete selfTestPing;
 }
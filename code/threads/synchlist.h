@@ -3,6 +3,12 @@
 //
 //	Identical interface to List, except accesses are synchronized.
 //
+//	A list may be given a capacity, in which case it also applies
+//	back-pressure: Append waits while the list is full, and TryAppend
+//	refuses the item instead, for callers that cannot wait.  AppendMany
+//	and RemoveUpTo move a batch of items with one lock acquire and one
+//	wakeup, rather than one of each per item.
+//
 // Copyright (c) 1992-1996 The Regents of the University of California.
 // All rights reserved.  See copyright.h for copyright notice and limitation 
 // of liability and disclaimer of warranty provisions.
@@ -19,18 +25,32 @@
 //	1. Threads trying to remove an item from a list will
 //	wait until the list has an element on it.
 //	2. One thread at a time can access list data structures
+//	3. If the list has a capacity, threads trying to append an
+//	item wait until there is room for it.
 
 template <class T>
 class SynchList {
   public:
-    SynchList();		// initialize a synchronized list
+    SynchList(int maxItems = 0);
+    				// initialize a synchronized list, holding
+				// at most "maxItems" items (0 = no limit)
     ~SynchList();		// de-allocate a synchronized list
 
     void Append(T item);	// append item to the end of the list,
-				// and wake up any thread waiting in remove
+				// and wake up any thread waiting in remove;
+				// waits if the list is full
+    bool TryAppend(T item);	// append item if there is room; return
+				// FALSE, without waiting, if the list is full
+    void AppendMany(T *items, int n);
+    				// append n items, waking up the waiters
+				// once per batch rather than once per item
 
     T RemoveFront();		// remove the first item from the front of
 				// the list, waiting if the list is empty
+    int RemoveUpTo(T *items, int n);
+    				// remove at least one and at most n items,
+				// waiting if the list is empty; return
+				// how many were removed
 
     void Apply(void (*f)(T)); // apply function to all elements in list
 
@@ -40,10 +60,16 @@ class SynchList {
     List<T> *list;		// the list of things
     Lock *lock;			// enforce mutual exclusive access to the list
     Condition *listEmpty;	// wait in Remove if the list is empty
+    Condition *listFull;	// wait in Append if the list is full
+    int capacity;		// most items on the list; 0 if no limit
+
+    bool IsFull()		// is there no room?  (hold the lock)
+	{ return capacity > 0 && (int) list->NumInList() >= capacity; }
     
     // these are only to assist SelfTest()
     SynchList<T> *selfTestPing;
     static void SelfTestHelper(void* data);
+    static void SelfTestBatchHelper(void* data);
 };
 
 #include "synchlist.cc"
@@ -0,0 +1,58 @@
+// task.cc
+//	Routines to run stackless kernel tasks, one step at a time, on
+//	the kernel's work queue.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "task.h"
+#include "workqueue.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// Task::Task
+//	Initialize a task.  It does nothing until it is started.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//----------------------------------------------------------------------
+
+Task::Task(char *debugName)
+{
+    name = debugName;
+    state = 0;
+}
+
+//----------------------------------------------------------------------
+// Task::Resume
+//	Arrange for the next step of the task to run on a kernel worker
+//	thread.  The step does not run right away, so an interrupt
+//	handler can resume a task when the I/O it waits for completes.
+//----------------------------------------------------------------------
+
+void
+Task::Resume()
+{
+    DEBUG(dbgThread, "Resuming task " << name << " at state " << state);
+    kernel->workQueue->Post(Task::RunStep, this);
+}
+
+//----------------------------------------------------------------------
+// Task::RunStep
+//	Run the next step of a task; delete the task once it is done.
+//
+//	"task" is the Task to run.
+//----------------------------------------------------------------------
+
+void
+Task::RunStep(void *task)
+{
+    Task *t = (Task *) task;
+
+    if (!t->Step()) {
+	DEBUG(dbgThread, "Task " << t->name << " is done");
+	delete t;
+    }
+}
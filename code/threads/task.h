@@ -0,0 +1,71 @@
+// task.h
+//	Data structures for stackless kernel tasks.
+//
+//	A thread that waits for I/O keeps its whole stack (and its Thread)
+//	while it sits in Semaphore::P.  A task is a continuation instead:
+//	a small object holding just the state it needs, plus a "step"
+//	routine.  The step runs until the task has to wait for I/O, starts
+//	the I/O (say, SynchDisk::ReadSectorAsync) and returns; when the
+//	I/O completes, the device's interrupt handler resumes the task,
+//	and the next step picks up where the last one left off, using the
+//	"state" field to tell where that was.  For example:
+//
+//	    bool CopySector::Step() {
+//		switch (state) {
+//		  case 0:	// start reading
+//		    state = 1;
+//		    kernel->synchDisk->ReadSectorAsync(from, buf, this);
+//		    return TRUE;
+//		  case 1:	// read done, start writing
+//		    state = 2;
+//		    kernel->synchDisk->WriteSectorAsync(to, buf, this);
+//		    return TRUE;
+//		  default:	// write done
+//		    return FALSE;
+//		}
+//	    }
+//
+//	Steps run on the kernel's work queue (see workqueue.h), so they
+//	borrow a worker's stack only while they run; outstanding tasks
+//	cost only their own few bytes.  A step must never block --
+//	that would tie up the worker -- and it must not keep anything
+//	on the stack from one step to the next.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "copyright.h"
+
+// The following class defines a stackless task.  Subclasses define
+// Step, and whatever state it needs.
+
+class Task {
+  public:
+    Task(char *debugName);	// initialize a task, at state 0
+    virtual ~Task() {}
+
+    void Start() { Resume(); }	// run the first step (later)
+    void Resume();		// run the next step (later); may be
+				// called from an interrupt handler
+
+    virtual bool Step() = 0;	// run until the next I/O, and start
+				// it; return FALSE if the task is
+				// done, and should be deleted
+
+    char *getName() { return name; }
+
+  protected:
+    int state;			// where the next step starts
+
+  private:
+    char *name;			// for debugging
+
+    static void RunStep(void *task);
+    				// run a step on a worker thread
+};
+
+#endif // TASK_H
@@ -41,9 +41,29 @@ Thread::Thread(char* threadName, int threadID)
     apprBurstTime = 0;
     lastCPU = 0;
     waitingTime = 0;
-    priority = kernel->execPriority[threadID];
+    setPriority(0);		// see Kernel::Exec
+    listBelong = 0;
+    readyIndex = -1;
+    cpuTicks = 0;
+    vruntime = 0;
+    share = NULL;
+    pass = 0;
+    realTime = NULL;
+    times = NULL;
+    trace = NULL;
+    basePriority = -1;
+    locksHeld = NULL;
+    waitingFor = NULL;
+    nextWaiter = NULL;
+    bursts = NULL;
+    group = NULL;
+    groupCharged = 0;
+    throttledSince = 0;
+    wakeBoost = 0;
+    ticketBoost = 0;
     stackTop = NULL;
     stack = NULL;
+    stackSize = StackSize;
     status = JUST_CREATED;
     for (int i = 0; i < MachineStateSize; i++) {
 	machineState[i] = NULL;		// not strictly necessary, since
@@ -53,6 +73,25 @@ Thread::Thread(char* threadName, int threadID)
     space = NULL;
 }
 
+//----------------------------------------------------------------------
+// Thread::setPriority
+// 	Set the priority of a thread that is not on the ready list, and
+//	seed its stride scheduling tickets from it.
+//----------------------------------------------------------------------
+
+void
+Thread::setPriority(int p)
+{
+    priority = p;
+    tickets = p;
+    ticketBoost = 0;			// a new count, no boost to take back
+    if (tickets < 1) {
+	tickets = 1;
+    } else if (tickets > MaxTickets) {
+	tickets = MaxTickets;
+    }
+}
+
 //----------------------------------------------------------------------
 // Thread::~Thread
 // 	De-allocate a thread.
@@ -69,8 +108,11 @@ Thread::~Thread()
 {
     DEBUG(dbgThread, "Deleting thread: " << name);
     ASSERT(this != kernel->currentThread);
+    if (kernel->processTable->Lookup(ID) == this) {
+	kernel->processTable->Free(ID);		// for the next program
+    }
     if (stack != NULL)
-	DeallocBoundedArray((char *) stack, StackSize * sizeof(int));
+	kernel->stackPool->Free(stack, stackSize);	// for the next thread
 }
 
 //----------------------------------------------------------------------
@@ -129,7 +171,7 @@ Thread::CheckOverflow()
 {
     if (stack != NULL) {
 #ifdef HPUX			// Stacks grow upward on the Snakes
-	ASSERT(stack[StackSize - 1] == STACK_FENCEPOST);
+	ASSERT(stack[stackSize - 1] == STACK_FENCEPOST);
 #else
 	ASSERT(*stack == STACK_FENCEPOST);
 #endif
@@ -203,6 +245,7 @@ Thread::Finish ()
 //----------------------------------------------------------------------
 void Thread::AccumulateBurstTime(int now){
     CPUBurstTime += now - lastCPU;
+    cpuTicks += now - lastCPU;
     lastCPU = now;
     dbgCPU = CPUBurstTime;
 }
@@ -225,11 +268,22 @@ Thread::Yield ()
     
     int now = kernel->stats->totalTicks;
     this->AccumulateBurstTime(now);
-    kernel->scheduler->age();
-    //preempting
-    if(this->listBelong == 3 || kernel->scheduler->preempting){
+    //preempting, if the scheduling policy says so
+    if(kernel->scheduler->ShouldYield(this)){
         nextThread = kernel->scheduler->FindNextToRun();
-        if (nextThread != NULL) {
+        if (nextThread == NULL && kernel->scheduler->OverQuota(this)) {
+            // no one else to run, but our process group is out of CPU
+            // for this window: idle until somebody may run, maybe us
+            this->lastWait = now;
+            kernel->scheduler->ReadyToRun(this);
+            while ((nextThread = kernel->scheduler->FindNextToRun()) == NULL) {
+                kernel->interrupt->Idle();
+            }
+            now = kernel->stats->totalTicks;
+            nextThread->lastCPU = now;
+            nextThread->resetWaiting(now);
+            kernel->scheduler->Run(nextThread, FALSE);
+        } else if (nextThread != NULL) {
             this->lastWait = now;
             nextThread->lastCPU = now;
             nextThread->resetWaiting(now);
@@ -264,7 +318,7 @@ Thread::Yield ()
 void Thread::UpdateBurst(int now){
     
     double old = apprBurstTime;
-    apprBurstTime = 0.5 * CPUBurstTime + 0.5 * apprBurstTime;
+    apprBurstTime = kernel->scheduler->PredictBurst(this, (int) CPUBurstTime);
     DEBUG(dbgMFQ, "[D] Tick ["<<
         kernel->stats->totalTicks<<
         "]: Thread ["<<
@@ -278,6 +332,7 @@ void Thread::UpdateBurst(int now){
         "]");
     dbgCPU = CPUBurstTime;
     CPUBurstTime = 0;
+    kernel->scheduler->Reorder(this);
 }
 void
 Thread::Sleep (bool finishing)
@@ -296,12 +351,17 @@ Thread::Sleep (bool finishing)
     AccumulateBurstTime(now);
     if(!finishing){
         UpdateBurst(now);
+        kernel->scheduler->Blocked(this);
+    }else{
+        kernel->scheduler->Finished(this);
     }
 	//cout << "debug Thread::Sleep " << name << "wait for Idle\n";
     while ((nextThread = kernel->scheduler->FindNextToRun()) == NULL) {
 		kernel->interrupt->Idle();	// no one to run, wait for an interrupt
 	}    
     // returns when it's time for us to run
+    // (time spent idle is nobody's CPU time)
+    now = kernel->stats->totalTicks;
     nextThread->lastCPU = now;
     nextThread->resetWaiting(now);
     kernel->scheduler->Run(nextThread, finishing); 
@@ -319,6 +379,18 @@ static void ThreadFinish()    { kernel->currentThread->Finish(); }
 static void ThreadBegin() { kernel->currentThread->Begin(); }
 void ThreadPrint(Thread *t) { t->Print(); }
 
+//----------------------------------------------------------------------
+// QueueLink, WaiterLink
+//	Where a thread keeps its links, so that ready lists and wait
+//	queues can chain threads together without allocating list
+//	elements.  A thread is on at most one ready list or semaphore
+//	queue at a time, but while it waits for a lock it is on both
+//	the lock's waiters and its semaphore's queue; hence two links.
+//----------------------------------------------------------------------
+
+ListLink<Thread *> *QueueLink(Thread *t) { return &t->queueLink; }
+ListLink<Thread *> *WaiterLink(Thread *t) { return &t->waiterLink; }
+
 #ifdef PARISC
 
 //----------------------------------------------------------------------
@@ -358,34 +430,34 @@ PLabelToAddr(void *plabel)
 void
 Thread::StackAllocate (VoidFunctionPtr func, void *arg)
 {
-    stack = (int *) AllocBoundedArray(StackSize * sizeof(int));
+    stack = kernel->stackPool->Allocate(stackSize);	// maybe recycled
 
 #ifdef PARISC
     // HP stack works from low addresses to high addresses
     // everyone else works the other way: from high addresses to low addresses
     stackTop = stack + 16;	// HP requires 64-byte frame marker
-    stack[StackSize - 1] = STACK_FENCEPOST;
+    stack[stackSize - 1] = STACK_FENCEPOST;
 #endif
 
 #ifdef SPARC
-    stackTop = stack + StackSize - 96; 	// SPARC stack must contains at 
+    stackTop = stack + stackSize - 96; 	// SPARC stack must contains at 
 					// least 1 activation record 
 					// to start with.
     *stack = STACK_FENCEPOST;
 #endif 
 
 #ifdef PowerPC // RS6000
-    stackTop = stack + StackSize - 16; 	// RS6000 requires 64-byte frame marker
+    stackTop = stack + stackSize - 16; 	// RS6000 requires 64-byte frame marker
     *stack = STACK_FENCEPOST;
 #endif 
 
 #ifdef DECMIPS
-    stackTop = stack + StackSize - 4;	// -4 to be on the safe side!
+    stackTop = stack + stackSize - 4;	// -4 to be on the safe side!
     *stack = STACK_FENCEPOST;
 #endif
 
 #ifdef ALPHA
-    stackTop = stack + StackSize - 8;	// -8 to be on the safe side!
+    stackTop = stack + stackSize - 8;	// -8 to be on the safe side!
     *stack = STACK_FENCEPOST;
 #endif
 
@@ -394,7 +466,7 @@ Thread::StackAllocate (VoidFunctionPtr func, void *arg)
     // the x86 passes the return address on the stack.  In order for SWITCH() 
     // to go to ThreadRoot when we switch to this thread, the return addres 
     // used in SWITCH() must be the starting address of ThreadRoot.
-    stackTop = stack + StackSize - 4;	// -4 to be on the safe side!
+    stackTop = stack + stackSize - 4;	// -4 to be on the safe side!
     *(--stackTop) = (int) ThreadRoot;
     *stack = STACK_FENCEPOST;
 #endif
@@ -24,7 +24,9 @@
 //	that your thread stacks are too small.)
 //	
 //	One thing to try if you find yourself with seg faults is to
-//	increase the size of thread stack -- ThreadStackSize.
+//	increase the size of thread stack -- ThreadStackSize.  Kernel
+//	threads that are known to need little stack can ask for less
+//	(setStackSize) before they are forked.
 //
 //  	In this interface, forking a thread takes two steps.
 //	We must first allocate a data structure for it: "t = new Thread".
@@ -40,9 +42,18 @@
 #include "copyright.h"
 #include "utility.h"
 #include "sysdep.h"
+#include "intrusivelist.h"
 #include "machine.h"
 #include "addrspace.h"
 
+class ShareRecord;
+class RealTimeRecord;
+class ThreadTimes;
+class TraceEntry;
+class Lock;
+class BurstHistory;
+class ProcessGroup;
+
 // CPU register state to be saved on context switch.  
 // The x86 needs to save only a few registers, 
 // SPARC and MIPS needs to save 10 registers, 
@@ -57,6 +68,12 @@
 // WATCH OUT IF THIS ISN'T BIG ENOUGH!!!!!
 const int StackSize = (8 * 1024);	// in words
 
+// A smaller stack, for kernel helper threads that don't call deep
+const int SmallStackSize = (4 * 1024);	// in words
+
+// Most tickets a thread can hold, for stride scheduling
+const int MaxTickets = 10000;
+
 
 // Thread state
 enum ThreadStatus { JUST_CREATED, RUNNING, READY, BLOCKED, ZOMBIE };
@@ -100,6 +117,11 @@ class Thread {
     void CheckOverflow();   	// Check if thread stack has overflowed
     void setStatus(ThreadStatus st) { status = st; }
     ThreadStatus getStatus() { return (status); }
+    void setPriority(int p);	// set priority, and the tickets that
+				// go with it
+    void setStackSize(int words) { ASSERT(stack == NULL);
+				   stackSize = words; }
+    				// stack to get when forked
 	char* getName() { return (name); }
     
 	int getID() { return (ID); }
@@ -117,12 +139,46 @@ class Thread {
   int lastWait;
   int waitingTime;
   int priority;
+  int readyIndex;		// position on an indexed ready queue
+  int cpuTicks;			// total CPU ticks used so far
+  double vruntime;		// weighted CPU time, for CFS
+  ShareRecord *share;		// fair share accounting, for CFS
+				// and stride
+  int tickets;			// CPU share, for stride scheduling
+  double pass;			// progress, for stride scheduling
+  RealTimeRecord *realTime;	// CPU reservation, NULL if not a
+				// real-time thread
+  ThreadTimes *times;		// lifecycle statistics, NULL until the
+				// thread is first made ready
+  TraceEntry *trace;		// bursts recorded so far, NULL unless
+				// recording a trace (-record)
+  int basePriority;		// own priority while "priority" is
+				// raised by the locks it holds, else -1
+  Lock *locksHeld;		// locks held, chained through
+				// Lock::nextHeld
+  Lock *waitingFor;		// lock blocked on in Acquire, or NULL
+  Thread *nextWaiter;		// next thread waiting on the same
+				// Condition
+  ListLink<Thread *> queueLink;	// on a ready list, a group's held-back
+				// threads, or a semaphore's queue
+  ListLink<Thread *> waiterLink;// on a lock's list of waiters
+  BurstHistory *bursts;		// recent CPU bursts, NULL until the
+				// first one ends
+  ProcessGroup *group;		// process group, NULL if none
+  int groupCharged;		// cpuTicks when the group was last
+				// charged for them
+  int throttledSince;		// when the group last held it back
+  int wakeBoost;		// priority added for waking from I/O,
+				// not yet decayed
+  int ticketBoost;		// and tickets, which MaxTickets may
+				// have kept smaller
   private:
     // some of the private data for this class is listed above
     
     int *stack; 	 	// Bottom of the stack 
 				// NULL if this is the main thread
 				// (If NULL, don't deallocate stack)
+    int stackSize;		// size of the stack, in words
     ThreadStatus status;	// ready, running or blocked
     char* name;
 	  int   ID;
@@ -146,6 +202,10 @@ class Thread {
 // external function, dummy routine whose sole job is to call Thread::Print
 extern void ThreadPrint(Thread *thread);	 
 
+// where a thread keeps its links, for IntrusiveLists of threads
+extern ListLink<Thread *> *QueueLink(Thread *thread);
+extern ListLink<Thread *> *WaiterLink(Thread *thread);
+
 // Magical machine-dependent routines, defined in switch.s
 
 extern "C" {
@@ -0,0 +1,94 @@
+// workload.cc
+//	Routines to generate a synthetic scheduler workload, and write it
+//	out as a scheduling trace.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "workload.h"
+#include "schedtrace.h"
+#include "main.h"
+#include <math.h>
+
+//----------------------------------------------------------------------
+// Workload::Workload
+//	Describe a workload; see workload.h.  Priorities default to the
+//	whole range, so under MLFQ threads land on all three levels.
+//----------------------------------------------------------------------
+
+Workload::Workload(int numThreads, int meanBurst, int meanIO, int meanGap,
+		   int numBursts)
+{
+    ASSERT(numThreads > 0 && meanBurst > 0 && numBursts > 0);
+    ASSERT(meanIO >= 0 && meanGap >= 0);
+    threads = numThreads;
+    burst = meanBurst;
+    io = meanIO;
+    gap = meanGap;
+    bursts = numBursts;
+    lowPriority = 0;
+    highPriority = kernel->schedParams->maxPriority;
+}
+
+//----------------------------------------------------------------------
+// Workload::Exponential
+//	Return an exponentially distributed number of ticks, "mean" on
+//	average (and 0 if "mean" is).
+//----------------------------------------------------------------------
+
+int
+Workload::Exponential(int mean)
+{
+    double u = (RandomNumber() % 10000 + 1) / 10001.0;	// in (0, 1)
+
+    return (int) (-mean * log(u) + 0.5);
+}
+
+//----------------------------------------------------------------------
+// Workload::Write
+//	Generate the workload and write it to "fileName", in the format
+//	of a scheduling trace.
+//----------------------------------------------------------------------
+
+void
+Workload::Write(char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    TraceEntry *entry;
+    char name[32];
+    int arrival = 0;
+    int priority, ticks;
+
+    ASSERT(0 <= lowPriority && lowPriority <= highPriority);
+    ASSERT(highPriority <= kernel->schedParams->maxPriority);
+    if (file == NULL) {
+	cerr << "Can't create workload file " << fileName << "\n";
+	Exit(1);
+    }
+    fprintf(file, "# %d threads, mean burst %d, I/O %d, gap %d, %d bursts\n",
+	    threads, burst, io, gap, bursts);
+    for (int i = 0; i < threads; i++) {
+	if (i > 0) {
+	    arrival += Exponential(gap);
+	}
+	priority = lowPriority +
+		   RandomNumber() % (highPriority - lowPriority + 1);
+	sprintf(name, "w%d", i + 1);
+	entry = new TraceEntry(name, arrival, priority);
+	for (int j = 0; j < bursts; j++) {
+	    if (j > 0) {
+		entry->events->Append(-Exponential(io));
+	    }
+	    ticks = Exponential(burst);
+	    entry->events->Append(ticks > 0 ? ticks : 1);
+	}
+	entry->Write(file);
+	delete entry;
+    }
+    fclose(file);
+    DEBUG(dbgThread, "Wrote a workload of " << threads << " threads to "
+	  << fileName);
+}
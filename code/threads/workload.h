@@ -0,0 +1,58 @@
+// workload.h
+//	Data structures to generate synthetic workloads for benchmarking
+//	the scheduler.
+//
+//	A workload is a number of threads that arrive at random times
+//	(exponentially distributed gaps, so arrivals are a Poisson
+//	process), each with a priority drawn uniformly from a range, and
+//	each alternating CPU bursts and I/O waits of exponentially
+//	distributed length.  The workload is written out as a scheduling
+//	trace (see schedtrace.h), so the same workload can be replayed
+//	under every policy, and compared:
+//
+//		nachos -workload w.trace 20 300 800 400 5 -sched mlfq
+//		nachos -replay w.trace -sched cfs
+//
+//	The random numbers come from RandomNumber, so a workload is the
+//	same from run to run unless -rs picks another seed.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "copyright.h"
+
+// The following class describes a synthetic workload.
+
+class Workload {
+  public:
+    Workload(int numThreads, int meanBurst, int meanIO, int meanGap,
+	     int numBursts);
+    				// "numThreads" threads, arriving every
+				// "meanGap" ticks, each running
+				// "numBursts" bursts of "meanBurst" ticks
+				// separated by "meanIO" ticks of I/O
+				// (all on average)
+
+    void SetPriorities(int low, int high) { lowPriority = low;
+					     highPriority = high; }
+    				// priorities are drawn from low..high
+
+    void Write(char *fileName);	// generate the workload, as a trace
+
+  private:
+    int threads;		// how many threads
+    int burst;			// mean CPU burst, in ticks
+    int io;			// mean I/O wait, in ticks
+    int gap;			// mean time between arrivals, in ticks
+    int bursts;			// CPU bursts per thread
+    int lowPriority;		// range of priorities
+    int highPriority;
+
+    int Exponential(int mean);	// random ticks, "mean" on average
+};
+
+#endif // WORKLOAD_H
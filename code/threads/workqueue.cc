@@ -0,0 +1,144 @@
+// workqueue.cc
+//	Routines to defer work from interrupt handlers to kernel worker
+//	threads.
+//
+//	The list of items is only touched with interrupts off, so that
+//	an interrupt handler can post to it at any time; the workers
+//	wait for items on a semaphore, as Semaphore::V is the one
+//	synchronization operation a handler is allowed.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "workqueue.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// WorkQueue::WorkQueue
+//	Initialize an empty queue.  No worker is forked until there is
+//	work to do.
+//
+//	"debugName" is an arbitrary name, useful for debugging.
+//	"maxWorkers" is the most worker threads the queue will use.
+//----------------------------------------------------------------------
+
+WorkQueue::WorkQueue(char *debugName, int maxWorkers)
+{
+    ASSERT(maxWorkers > 0);
+    name = debugName;
+    items = new List<WorkItem *>;
+    available = new Semaphore(debugName, 0);
+    maxThreads = maxWorkers;
+    numThreads = idleThreads = 0;
+    numPosted = numDone = maxDepth = 0;
+    totalLatency = maxLatency = 0;
+}
+
+//----------------------------------------------------------------------
+// WorkQueue::~WorkQueue
+//	De-allocate the items that never ran.  As in PostOfficeInput,
+//	the semaphore the workers wait on is left allocated.
+//----------------------------------------------------------------------
+
+WorkQueue::~WorkQueue()
+{
+    while (!items->IsEmpty()) {
+	delete items->RemoveFront();
+    }
+    delete items;
+}
+
+//----------------------------------------------------------------------
+// WorkQueue::Post
+//	Arrange for func(arg) to be called on a worker thread.  If every
+//	worker is busy (or there are none yet), and the pool is not
+//	full, fork another.
+//
+//	Interrupts are disabled, so that this can be called from an
+//	interrupt handler or from a thread.
+//----------------------------------------------------------------------
+
+void
+WorkQueue::Post(VoidFunctionPtr func, void *arg)
+{
+    IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+    int depth;
+
+    items->Append(new WorkItem(func, arg, kernel->stats->totalTicks));
+    numPosted++;
+    depth = items->NumInList();
+    if (depth > maxDepth) {
+	maxDepth = depth;
+    }
+    if (idleThreads < depth && numThreads < maxThreads) {
+	Thread *t = new Thread(name, 1);
+
+	DEBUG(dbgThread, "Forking worker " << numThreads << " of " << name);
+	numThreads++;
+	idleThreads++;
+	t->setStackSize(SmallStackSize);
+	t->Fork(WorkQueue::Worker, this);
+    }
+    available->V();
+    (void) kernel->interrupt->SetLevel(oldLevel);
+}
+
+//----------------------------------------------------------------------
+// WorkQueue::Worker
+//	Wait for work, and do it, forever.
+//
+//	"queue" is the WorkQueue the worker belongs to.
+//----------------------------------------------------------------------
+
+void
+WorkQueue::Worker(void *queue)
+{
+    WorkQueue *_this = (WorkQueue *) queue;
+
+    for (;;) {
+	_this->available->P();
+
+	IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+	WorkItem *item = _this->items->RemoveFront();
+	int latency = kernel->stats->totalTicks - item->posted;
+
+	_this->idleThreads--;
+	_this->totalLatency += latency;
+	if (latency > _this->maxLatency) {
+	    _this->maxLatency = latency;
+	}
+	(void) kernel->interrupt->SetLevel(oldLevel);
+
+	(*item->func)(item->arg);
+	delete item;
+
+	oldLevel = kernel->interrupt->SetLevel(IntOff);
+	_this->numDone++;
+	_this->idleThreads++;
+	(void) kernel->interrupt->SetLevel(oldLevel);
+    }
+}
+
+//----------------------------------------------------------------------
+// WorkQueue::PrintStats
+//	Print how much work was posted, how deep the queue got, and how
+//	long work waited to start.  Nothing, if the queue was never used.
+//----------------------------------------------------------------------
+
+void
+WorkQueue::PrintStats()
+{
+    int started = numPosted - items->NumInList();
+
+    if (numPosted == 0) {
+	return;
+    }
+    cout << "Work queue " << name << ": posted " << numPosted;
+    cout << ", done " << numDone << ", workers " << numThreads;
+    cout << ", max depth " << maxDepth << "\n";
+    cout << "    latency: mean " << (started > 0 ? totalLatency / started : 0);
+    cout << ", max " << maxLatency << "\n";
+}
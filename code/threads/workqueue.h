@@ -0,0 +1,76 @@
+// workqueue.h
+//	Data structures for deferring work out of interrupt handlers.
+//
+//	An interrupt handler runs with interrupts off, and cannot block,
+//	so it cannot acquire a Lock.  Rather than fork a daemon thread
+//	for every device that has to do more than a Semaphore::V (as the
+//	post office used to), a handler posts a function and its argument
+//	to a work queue; a small pool of kernel worker threads runs them
+//	later, in the order they were posted, with interrupts enabled.
+//
+//	Workers are forked on demand, when work is posted and every
+//	worker is busy, up to the size of the pool.  A queue that is
+//	never used has no threads at all.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include "copyright.h"
+#include "utility.h"
+#include "list.h"
+#include "synch.h"
+
+const int KernelWorkers = 2;	// worker threads of the kernel's queue
+
+// The following class defines one piece of deferred work.
+
+class WorkItem {
+  public:
+    WorkItem(VoidFunctionPtr workFunc, void *workArg, int now)
+	{ func = workFunc; arg = workArg; posted = now; }
+
+    VoidFunctionPtr func;	// what to do
+    void *arg;			// and what to do it to
+    int posted;			// when it was posted, in ticks
+};
+
+// The following class defines a queue of deferred work, and the
+// worker threads that do it.
+
+class WorkQueue {
+  public:
+    WorkQueue(char *debugName, int maxWorkers);
+    				// at most "maxWorkers" worker threads
+    ~WorkQueue();		// de-allocate the queue; the workers
+				// are left waiting, as they may be
+				// running on it
+
+    void Post(VoidFunctionPtr func, void *arg);
+    				// call func(arg) on a worker thread;
+				// may be called from an interrupt handler
+
+    void PrintStats();		// depth and latency of the queue
+
+  private:
+    char *name;			// for debugging
+    List<WorkItem *> *items;	// posted, not yet started
+    Semaphore *available;	// one V for every item posted
+    int maxThreads;		// most worker threads to fork
+    int numThreads;		// worker threads forked so far
+    int idleThreads;		// of those, how many are waiting for work
+
+    int numPosted;		// statistics
+    int numDone;
+    int maxDepth;		// most items waiting at once
+    int totalLatency;		// ticks from Post to start, in total
+    int maxLatency;		// and at most
+
+    static void Worker(void *queue);
+    				// run the items, forever
+};
+
+#endif // WORKQUEUE_H
@@ -290,6 +290,8 @@ AddrSpace::Execute(char* fileName)
 
     kernel->currentThread->space = this;
 
+    // save the registers of the user program in the machine, if any
+    kernel->scheduler->LoadUserState(kernel->currentThread);
     this->InitRegisters();		// set the initial register values
     this->RestoreState();		// load page table register
 
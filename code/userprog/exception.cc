@@ -79,6 +79,55 @@ ExceptionHandler(ExceptionType which)
 			ASSERTNOTREACHED();
 		    break;
 
+	    case SC_SetTickets:
+			val = kernel->machine->ReadRegister(4);
+			DEBUG(dbgSys, "Set tickets to " << val << "\n");
+			status = SysSetTickets(val);
+			kernel->machine->WriteRegister(2, (int) status);
+			// Set Program Counter
+			kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+			kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+			kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg)+4);
+			return;
+			ASSERTNOTREACHED();
+		    break;
+
+	    case SC_SetRealTime:
+			DEBUG(dbgSys, "Set real-time " << kernel->machine->ReadRegister(5) << "/" << kernel->machine->ReadRegister(4) << "\n");
+			status = SysSetRealTime((int)kernel->machine->ReadRegister(4), (int)kernel->machine->ReadRegister(5));
+			kernel->machine->WriteRegister(2, (int) status);
+			// Set Program Counter
+			kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+			kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+			kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg)+4);
+			return;
+			ASSERTNOTREACHED();
+		    break;
+
+	    case SC_FutexWait:
+			DEBUG(dbgSys, "Futex wait on " << kernel->machine->ReadRegister(4) << "\n");
+			status = SysFutexWait((int)kernel->machine->ReadRegister(4), (int)kernel->machine->ReadRegister(5));
+			kernel->machine->WriteRegister(2, (int) status);
+			// Set Program Counter
+			kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+			kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+			kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg)+4);
+			return;
+			ASSERTNOTREACHED();
+		    break;
+
+	    case SC_FutexWake:
+			DEBUG(dbgSys, "Futex wake on " << kernel->machine->ReadRegister(4) << "\n");
+			status = SysFutexWake((int)kernel->machine->ReadRegister(4), (int)kernel->machine->ReadRegister(5));
+			kernel->machine->WriteRegister(2, (int) status);
+			// Set Program Counter
+			kernel->machine->WriteRegister(PrevPCReg, kernel->machine->ReadRegister(PCReg));
+			kernel->machine->WriteRegister(PCReg, kernel->machine->ReadRegister(PCReg) + 4);
+			kernel->machine->WriteRegister(NextPCReg, kernel->machine->ReadRegister(PCReg)+4);
+			return;
+			ASSERTNOTREACHED();
+		    break;
+
 	    case SC_Open:
 			DEBUG(dbgSys, "Open a file, initiated by user program.\n");
 			val = kernel->machine->ReadRegister(4);
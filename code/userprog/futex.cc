@@ -0,0 +1,163 @@
+// futex.cc
+//	Routines to put user threads to sleep on, and wake them up from,
+//	words of user memory.
+//
+//	Interrupts are disabled while a futex word is checked and its
+//	queue changed, as Semaphore::P does; user programs can then
+//	build any synchronization they like on top (see test/ulock.c).
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#include "copyright.h"
+#include "debug.h"
+#include "futex.h"
+#include "main.h"
+
+//----------------------------------------------------------------------
+// FutexKey, FutexHash
+//	Functions the hash table needs: a futex queue's key is the
+//	physical address of its word.
+//----------------------------------------------------------------------
+
+static int
+FutexKey(FutexQueue *queue)
+{
+    return queue->address;
+}
+
+static unsigned
+FutexHash(int address)
+{
+    return (unsigned) address / 4;	// futex words are aligned
+}
+
+//----------------------------------------------------------------------
+// FutexTable::FutexTable
+//	Initialize an empty table of futexes.
+//----------------------------------------------------------------------
+
+FutexTable::FutexTable()
+{
+    queues = new HashTable<int, FutexQueue *>(FutexKey, FutexHash);
+}
+
+//----------------------------------------------------------------------
+// FutexTable::~FutexTable
+//	De-allocate the table.  Any threads still waiting are never
+//	woken up, so their queues are left allocated.
+//----------------------------------------------------------------------
+
+FutexTable::~FutexTable()
+{
+    delete queues;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::PhysAddr
+//	Translate a futex address in the current thread's address
+//	space; return -1 if it is unaligned or not mapped.
+//----------------------------------------------------------------------
+
+int
+FutexTable::PhysAddr(int virtAddr)
+{
+    unsigned int physAddr;
+
+    if ((virtAddr & 0x3) != 0 ||
+	kernel->currentThread->space->Translate(virtAddr, &physAddr, 0)
+							!= NoException) {
+	return -1;
+    }
+    return physAddr;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Wait
+//	Put the current thread to sleep on the futex at "virtAddr", if
+//	the word there still holds "expected".  If it does not, the
+//	thread that changed it may already have called Wake, so
+//	sleeping could miss the wakeup; return right away instead.
+//
+//	Return 0 if the thread slept (and has been woken up), 1 if the
+//	word had changed, and -1 if "virtAddr" is not a good address.
+//----------------------------------------------------------------------
+
+int
+FutexTable::Wait(int virtAddr, int expected)
+{
+    Thread *thread = kernel->currentThread;
+    int physAddr = PhysAddr(virtAddr);
+    FutexQueue *queue;
+    IntStatus oldLevel;
+    int value;
+
+    if (physAddr < 0) {
+	return -1;
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    value = WordToHost(*(unsigned int *) &kernel->machine->mainMemory[physAddr]);
+    if (value != expected) {
+	(void) kernel->interrupt->SetLevel(oldLevel);
+	return 1;
+    }
+    if (!queues->Find(physAddr, &queue)) {
+	queue = new FutexQueue(physAddr);
+	queues->Insert(queue);
+    }
+    DEBUG(dbgSynch, "Thread " << thread->getName() << " waits on futex "
+	  << virtAddr);
+    thread->nextWaiter = NULL;
+    if (queue->lastWaiter == NULL) {
+	queue->firstWaiter = thread;
+    } else {
+	queue->lastWaiter->nextWaiter = thread;
+    }
+    queue->lastWaiter = thread;
+    kernel->stats->numFutexWaits++;
+    thread->Sleep(FALSE);
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// FutexTable::Wake
+//	Wake up to "count" threads waiting on the futex at "virtAddr",
+//	in the order they went to sleep.  The queue goes away once it
+//	is empty.
+//
+//	Return how many threads were woken up, or -1 if "virtAddr" is
+//	not a good address.
+//----------------------------------------------------------------------
+
+int
+FutexTable::Wake(int virtAddr, int count)
+{
+    int physAddr = PhysAddr(virtAddr);
+    FutexQueue *queue;
+    IntStatus oldLevel;
+    int woken = 0;
+
+    if (physAddr < 0) {
+	return -1;
+    }
+    oldLevel = kernel->interrupt->SetLevel(IntOff);
+    if (queues->Find(physAddr, &queue)) {
+	while (woken < count && queue->firstWaiter != NULL) {
+	    Thread *thread = queue->firstWaiter;
+
+	    queue->firstWaiter = thread->nextWaiter;
+	    thread->nextWaiter = NULL;
+	    kernel->scheduler->ReadyToRun(thread);
+	    woken++;
+	}
+	if (queue->firstWaiter == NULL) {
+	    (void) queues->Remove(physAddr);
+	    delete queue;
+	}
+    }
+    kernel->stats->numFutexWakes += woken;
+    (void) kernel->interrupt->SetLevel(oldLevel);
+    return woken;
+}
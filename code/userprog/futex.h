@@ -0,0 +1,68 @@
+// futex.h
+//	Data structures for user-level synchronization: "futexes" (fast
+//	user-space mutexes), as in Linux.
+//
+//	A user-level lock or condition variable is just a word of user
+//	memory.  While it is not contended, the user program updates it
+//	with CompareAndSwap (an LL/SC loop, see start.S) without ever
+//	trapping into the kernel.  Only to wait, or to wake up a waiter,
+//	does it make a system call:
+//
+//		FutexWait(addr, val)	sleep, if *addr is still val
+//		FutexWake(addr, n)	wake up to n threads sleeping on addr
+//
+//	Checking *addr and going to sleep are atomic, so a wakeup between
+//	the program's last look at *addr and its FutexWait is not lost.
+//	Waiters are kept by *physical* address, so the same word seen
+//	through different page tables is the same futex.
+//
+//	See test/ulock.c for the user side.
+//
+// Copyright (c) 1992-1996 The Regents of the University of California.
+// All rights reserved.  See copyright.h for copyright notice and limitation
+// of liability and disclaimer of warranty provisions.
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include "copyright.h"
+#include "hash.h"
+
+class Thread;
+
+// The following class defines the threads waiting on one futex.
+// It only exists while some thread is waiting.
+
+class FutexQueue {
+  public:
+    FutexQueue(int physAddr) { address = physAddr;
+			       firstWaiter = lastWaiter = NULL; }
+
+    int address;		// physical address of the futex word
+    Thread *firstWaiter;	// waiting threads, chained through
+    Thread *lastWaiter;		// Thread::nextWaiter
+};
+
+// The following class defines all the futexes in use.
+
+class FutexTable {
+  public:
+    FutexTable();		// no futexes yet
+    ~FutexTable();		// de-allocate the table
+
+    int Wait(int virtAddr, int expected);
+    				// put the current thread to sleep on
+				// virtAddr, unless it no longer holds
+				// "expected"; 0 if it slept, 1 if not,
+				// -1 if virtAddr is bad
+    int Wake(int virtAddr, int count);
+    				// wake up to "count" threads waiting on
+				// virtAddr; return how many, or -1
+
+  private:
+    HashTable<int, FutexQueue *> *queues;	// by physical address
+
+    int PhysAddr(int virtAddr);	// translate, or -1 if bad
+};
+
+#endif // FUTEX_H
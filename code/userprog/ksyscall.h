@@ -14,6 +14,7 @@
 #include "kernel.h"
 
 #include "synchconsole.h"
+#include "futex.h"
 
 
 void SysHalt()
@@ -33,6 +34,42 @@ int SysAdd(int op1, int op2)
   return op1 + op2;
 }
 
+int SysSetTickets(int tickets)
+{
+  Thread *thread = kernel->currentThread;
+  int old = thread->tickets;
+
+  if (tickets < 1 || tickets > MaxTickets) {
+    return -1;
+  }
+  // the scheduler picks up the change the next time it charges us;
+  // any wake-up boost still on the old count is dropped, rather than
+  // taken off the new one as it decays
+  thread->tickets = tickets;
+  thread->ticketBoost = 0;
+  return old;
+}
+
+int SysSetRealTime(int period, int budget)
+{
+  IntStatus oldLevel = kernel->interrupt->SetLevel(IntOff);
+  int result = kernel->scheduler->SetRealTime(kernel->currentThread,
+                                              period, budget);
+
+  (void) kernel->interrupt->SetLevel(oldLevel);
+  return result;
+}
+
+int SysFutexWait(int addr, int val)
+{
+  return kernel->futexTable->Wait(addr, val);
+}
+
+int SysFutexWake(int addr, int count)
+{
+  return kernel->futexTable->Wake(addr, count);
+}
+
 int SysCreate(char *filename)
 {
 	// return value
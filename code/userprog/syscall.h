@@ -35,6 +35,10 @@
 #define SC_ThreadExit   14
 #define SC_ThreadJoin   15
 #define SC_PrintInt     16
+#define SC_SetTickets   17
+#define SC_SetRealTime  18
+#define SC_FutexWait    19
+#define SC_FutexWake    20
 #define SC_Add		42
 #define SC_MSG		100
 #ifndef IN_ASM
@@ -64,6 +68,37 @@ int Add(int op1, int op2);
  */
 void MSG(char *msg);
 
+/* Set the number of scheduling tickets (1..10000) the current thread
+ * holds; under "-sched stride" its share of the CPU is proportional
+ * to them.  Return the old number, or -1 if "tickets" is out of range.
+ */
+int SetTickets(int tickets);
+
+/* Make the current thread real-time: it is guaranteed "budget" ticks
+ * of CPU every "period" ticks, ahead of every other thread, but gets
+ * no more than that while others are waiting.  Return 0 on success,
+ * or -1 if the reservation cannot be admitted (the reservations of
+ * all threads together may not exceed the CPU).  A period of 0
+ * cancels the reservation.
+ */
+int SetRealTime(int period, int budget);
+
+/* Futexes: the kernel half of user-level locks and condition variables
+ * (see test/ulock.h).  FutexWait puts the current thread to sleep if
+ * *addr still holds "val", and returns 0 once woken up, or 1 at once if
+ * *addr has changed.  FutexWake wakes up to "count" threads sleeping on
+ * addr, and returns how many it woke.  Both return -1 if addr is not a
+ * word-aligned address in this program.
+ */
+int FutexWait(int *addr, int val);
+int FutexWake(int *addr, int count);
+
+/* Atomically: if *addr holds "oldVal", store "newVal" there and return 1;
+ * otherwise return 0.  Runs entirely in user mode (an LL/SC loop), so
+ * it never traps into the kernel.
+ */
+int CompareAndSwap(int *addr, int oldVal, int newVal);
+
 /* Address space control operations: Exit, Exec, Execv, and Join */
 
 /* This user program is done (status = 0 means exited normally). */